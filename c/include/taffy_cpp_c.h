@@ -1285,6 +1285,95 @@ extern "C" {
             taffy_AvailableSpace* taffy_Size_of_AvailableSpace_get_mut_width (taffy_Size_of_AvailableSpace* self);
             taffy_AvailableSpace* taffy_Size_of_AvailableSpace_get_mut_height(taffy_Size_of_AvailableSpace* self);
 
+            /* MeasureFunc -------------------------------------------------- */
+
+            /*
+                Measure function of leaf node (for example - text). Arguments
+                are passed by value, as plain structs, to keep calls cheap.
+            */
+
+            typedef enum {
+                taffy_AvailableSpace_Type_Definite = 0,
+                taffy_AvailableSpace_Type_MinContent,
+                taffy_AvailableSpace_Type_MaxContent
+            } taffy_AvailableSpace_Type;
+
+            /* Size<Option<float>> */
+            typedef struct {
+                /* bool */ int width_is_some;
+                float          width; /* valid only if 'width_is_some' */
+
+                /* bool */ int height_is_some;
+                float          height; /* valid only if 'height_is_some' */
+            } taffy_MeasureKnownDimensions;
+
+            /* Size<AvailableSpace> */
+            typedef struct {
+                taffy_AvailableSpace_Type width_type;
+                float                     width; /* valid only for 'Definite' */
+
+                taffy_AvailableSpace_Type height_type;
+                float                     height; /* valid only for 'Definite' */
+            } taffy_MeasureAvailableSpace;
+
+            /* Size<float> */
+            typedef struct {
+                float width;
+                float height;
+            } taffy_MeasureSize;
+
+            typedef taffy_MeasureSize (*taffy_MeasureFunc)(
+                taffy_MeasureKnownDimensions known_dimensions,
+                taffy_MeasureAvailableSpace  available_space,
+                void*                        user_data
+            );
+
+            /* Batch measure (see 'taffy_Taffy_set_batch_measure()') */
+            typedef struct {
+                taffy_NodeId                 node;
+                void*                        user_data; /* node's measure 'user_data' */
+                taffy_MeasureKnownDimensions known_dimensions;
+                taffy_MeasureAvailableSpace  available_space;
+            } taffy_MeasureRequest;
+
+            /* Measure cache statistics (see 'taffy_Taffy_set_measure_cache()') */
+            typedef struct {
+                uint64_t hits;
+                uint64_t misses;
+                uint64_t evictions;
+            } taffy_MeasureCacheStats;
+
+            /* must write 'results[i]' for each 'requests[i]' */
+            typedef void (*taffy_BatchMeasureFunc)(
+                const taffy_MeasureRequest* requests, size_t requests_count,
+                taffy_MeasureSize*          results,
+                void*                       user_data
+            );
+
+            /* Built-in fixed-metrics text measure (monospace text, terminal
+               cells, etc.): measured natively, without any callback.
+            */
+            typedef enum {
+                taffy_FixedText_Wrap_None  = 0, /* single line */
+                taffy_FixedText_Wrap_Glyph = 1, /* line may break after any glyph */
+                taffy_FixedText_Wrap_Word  = 2  /* line may break only at 'break_offsets' */
+            } taffy_FixedText_Wrap;
+
+            typedef struct {
+                size_t               glyph_count;
+                float                advance;     /* width of each glyph */
+                float                line_height;
+                taffy_FixedText_Wrap wrap;
+
+                /* Glyph offsets at which line may start (for Word wrap),
+                   copied. Unsorted, duplicated and out of (0, glyph_count)
+                   range offsets are allowed (ignored). Word, longer than
+                   available width, overflows the line.
+                */
+                const size_t* break_offsets;
+                size_t        break_offsets_count;
+            } taffy_FixedText;
+
     typedef struct taffy_Taffy taffy_Taffy;
 
     /* constructors */
@@ -1298,6 +1387,21 @@ extern "C" {
     void taffy_Taffy_enable_rounding (taffy_Taffy* self);
     void taffy_Taffy_disable_rounding(taffy_Taffy* self);
 
+    /*
+        With enabled rounding: round only nodes laid out again by computation
+        (dirty ones and their children), not the whole laid out tree. Deeper
+        nodes keep previous rounding - exact, unless their subtree moved by
+        fraction of pixel. Disabled by default.
+
+        Rounded layouts are stored apart from unrounded ones (which taffy keeps
+        for incremental relayouts), so layouts never rounded twice.
+    */
+    void taffy_Taffy_set_rounding_dirty_only(
+        taffy_Taffy* self,
+
+        /* bool */ int dirty_only
+    );
+
     /* methods */
     taffy_TaffyResult_of_NodeId taffy_Taffy_new_leaf(
         taffy_Taffy* self,
@@ -1305,7 +1409,20 @@ extern "C" {
         const taffy_Style* layout
     );
 
-    /* TODO: new_leaf_with_measure(...) */
+    /* 'user_data' is not owned by tree, it passed into each 'measure' call */
+    taffy_TaffyResult_of_NodeId taffy_Taffy_new_leaf_with_measure(
+        taffy_Taffy* self,
+
+        const taffy_Style* layout,
+        taffy_MeasureFunc measure, void* user_data
+    );
+
+    taffy_TaffyResult_of_NodeId taffy_Taffy_new_leaf_with_fixed_text(
+        taffy_Taffy* self,
+
+        const taffy_Style* layout,
+        const taffy_FixedText* text
+    );
 
     taffy_TaffyResult_of_NodeId taffy_Taffy_new_with_children(
         taffy_Taffy* self,
@@ -1322,7 +1439,72 @@ extern "C" {
         taffy_NodeId node
     );
 
-    /* TODO: set_measure(...) */
+    /* null 'measure' - removes measure function from node */
+    taffy_TaffyResult_of_void taffy_Taffy_set_measure(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, taffy_MeasureFunc measure, void* user_data
+    );
+
+    /* 'user_data' of node's measure function. null - if node has no measure
+       function (or node not exists)
+    */
+    void* taffy_Taffy_get_measure_user_data(
+        const taffy_Taffy* self,
+
+        taffy_NodeId node
+    );
+
+    /* Replaces node's measure function by built-in fixed-metrics text
+       measure. Removed the same way, by 'taffy_Taffy_set_measure(node, NULL)'.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_set_fixed_text(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, const taffy_FixedText* text
+    );
+
+    /* Batch measure mode (null 'measure' - disables it).
+
+       In this mode 'taffy_Taffy_compute_layout()' not calls per-node measure
+       functions: it collects measure requests of all measured leaves and
+       passes them into single 'measure' call. Since taffy needs measure
+       result immediately, it is done in rounds: layout computed with
+       provisional results while requests collected, then requests measured
+       and layout recomputed for affected leaves - until no new requests
+       appear (typically 1-2 rounds, after several rounds remaining requests
+       measured one-by-one). Requests order is deterministic (order of first
+       occurrence during layout).
+    */
+    void taffy_Taffy_set_batch_measure(
+        taffy_Taffy* self,
+
+        taffy_BatchMeasureFunc measure, void* user_data
+    );
+
+    /* Measure results cache: up to 'entries_per_node' results per measured
+       leaf (0 - disabled, by default), evicted in FIFO order. Float inputs
+       (known dimensions, definite available space) are matched with
+       'tolerance'. Changing config drops all cached results.
+    */
+    void taffy_Taffy_set_measure_cache(
+        taffy_Taffy* self,
+
+        size_t entries_per_node, float tolerance
+    );
+
+    taffy_MeasureCacheStats taffy_Taffy_measure_cache_stats(const taffy_Taffy* self);
+
+    void taffy_Taffy_reset_measure_cache_stats(taffy_Taffy* self);
+
+    /* Drops cached measure results of node (when its content changed, for
+       example - text) and marks it dirty.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_invalidate_measure(
+        taffy_Taffy* self,
+
+        taffy_NodeId node
+    );
 
     taffy_TaffyResult_of_void taffy_Taffy_add_child(
         taffy_Taffy* self,
@@ -1413,12 +1595,759 @@ extern "C" {
         taffy_NodeId node
     );
 
+    /*
+        Nodes changed directly (style, children, measure, 'mark_dirty()')
+        since they were laid out, in order of change - their ancestors are
+        dirty too. Zero - nothing to lay out. Nodes are dropped from the list
+        by layout computation, which made them clean.
+    */
+    size_t taffy_Taffy_dirty_count(const taffy_Taffy* self);
+
+    /* writes at most 'capacity' nodes, returns count of all dirty nodes */
+    size_t taffy_Taffy_dirty_nodes(
+        const taffy_Taffy* self,
+
+        taffy_NodeId* out_nodes, size_t capacity
+    );
+
     taffy_TaffyResult_of_void taffy_Taffy_compute_layout(
         taffy_Taffy* self,
 
         taffy_NodeId node, const taffy_Size_of_AvailableSpace* available_space
     );
 
+    /*
+        Relayout boundary - node, which size not depends on its parent, nor on
+        its content. Detected automatically for nodes with: Length width and
+        height, Length (or Auto) min and max sizes, zero flex grow and shrink,
+        Auto flex basis, Length padding and border (not 'display: none').
+        Other nodes may be explicitly flagged by this function: they are
+        laid out as roots, in available space of their previous size - if
+        such layout comes out at other size (node sized by its content), the
+        whole tree is laid out instead. Nodes attached after the last layout
+        of their tree are not taken.
+
+        Taffy propagates dirtiness up to the root, but binding records where
+        changes happened: if all of them are inside of boundaries, next
+        'taffy_Taffy_compute_layout()' (with the same root and available space)
+        lays out again only subtrees of these boundaries, at their previous
+        sizes. Otherwise - the whole tree. After such partial layout root and
+        other ancestors of boundaries are up to date - not reported as dirty.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_set_relayout_boundary(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, /* bool */ int is_boundary
+    );
+
+    /*
+        Layout of 'node', computed lazily: if its tree root was laid out at
+        'root_space' before and the nearest relayout boundary above the node
+        has fixed size by style (not only flagged), only subtree of this
+        boundary is laid out again (if dirty) - rest of the tree stays dirty
+        for the next full pass. With rounding enabled, only this subtree is
+        rounded, at the boundary's current absolute position. Otherwise
+        (flagged boundary or no boundary) - 'taffy_Taffy_compute_layout()'
+        from the tree root.
+    */
+    taffy_TaffyResult_of_Layout_const_ref taffy_Taffy_layout_resolved(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, const taffy_Size_of_AvailableSpace* root_space
+    );
+
+    /*
+        Lays out subtree of 'node' again, as root, keeping its position. Node
+        must have fixed size by style (detected relayout boundary, see
+        'taffy_Taffy_set_relayout_boundary()'): constraints the parent gave to
+        the node are not kept, so other nodes could not be laid out exactly.
+        If the node was not laid out yet - its tree is laid out again from the
+        root, at the root's last available space (only recorded per root).
+        Tree root itself is laid out at that space.
+
+        Error ('InvalidInputNode', with root node) if its tree root was never
+        laid out; ('InvalidInputNode', with 'node') if its size is not fixed.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_recompute_subtree(
+        taffy_Taffy* self,
+
+        taffy_NodeId node
+    );
+
+    /* Structure-of-arrays layout results of single viewport. Any array may be
+       null - then it is not written. Nodes are in pre-order from root (the
+       same for all viewports), 'x' and 'y' - relative to parent.
+    */
+    typedef struct {
+        taffy_NodeId* nodes;
+        float*        x;
+        float*        y;
+        float*        width;
+        float*        height;
+        size_t        capacity; /* items count of each array */
+
+        size_t count; /* [out] nodes count in subtree (only first 'capacity' written) */
+    } taffy_LayoutBuffers;
+
+    /*
+        Convenience loop: lays out the whole tree for each of
+        'available_spaces' in turn (as 'taffy_Taffy_compute_layout()' would),
+        writing results into 'buffers[i]' - costs the same as separate
+        calls, one full layout per viewport.
+
+        'restore' != 0 - tree own layouts are laid out again for available
+        space of previous 'taffy_Taffy_compute_layout()' (if it was done for
+        the same root), otherwise they are left from the last viewport.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_compute_layout_multi(
+        taffy_Taffy* self,
+
+        taffy_NodeId root,
+        const taffy_Size_of_AvailableSpace* const* available_spaces, size_t count,
+        taffy_LayoutBuffers* buffers,
+        /* bool */ int restore
+    );
+
+    /* Per-node context ----------------------------------------------------- */
+
+    /* Arbitrary user pointer, attached to node (for example - pointer to
+       widget, represented by node), to not map 'taffy_NodeId' back to user
+       objects. Not owned by tree. Handed back in visitor callbacks.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_set_context(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, void* context
+    );
+
+    /* null - if not set (or node not exists) */
+    void* taffy_Taffy_get_context(
+        const taffy_Taffy* self,
+
+        taffy_NodeId node
+    );
+
+    /* Layout visitor ------------------------------------------------------- */
+
+    typedef struct {
+        taffy_NodeId node;
+        taffy_NodeId parent; /* equal to 'node' for visit root */
+        size_t       depth;  /* 0 for visit root */
+        uint32_t     order;
+
+        /* rect, relative to parent */
+        float x;
+        float y;
+        float width;
+        float height;
+
+        /* rect, relative to visit root's parent (size is the same) */
+        float abs_x;
+        float abs_y;
+
+        void*    context;    /* see 'taffy_Taffy_set_context()' */
+        uint64_t generation; /* see 'taffy_Taffy_layout_generation()' */
+    } taffy_LayoutVisit;
+
+    typedef enum {
+        taffy_VisitAction_Continue = 0,
+        taffy_VisitAction_SkipChildren,
+        taffy_VisitAction_Stop
+    } taffy_VisitAction;
+
+    /* returns 'taffy_VisitAction' value */
+    typedef int (*taffy_LayoutVisitor)(const taffy_LayoutVisit* visit, void* user_data);
+
+    /* Depth-first (pre-order) walk over computed layouts, without allocations.
+       Visitor called once per node, its return value may skip node's subtree
+       or stop the walk. Waits for asynchronous computation (if any).
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_visit_layouts(
+        const taffy_Taffy* self,
+
+        taffy_NodeId root, taffy_LayoutVisitor visitor, void* user_data
+    );
+
+    /* Traversal ------------------------------------------------------------ */
+
+    /* Each function returns 1 (true) and writes 'out_node', if it exists,
+       otherwise returns 0 (false). 'out_node' may be null.
+
+       All are O(1): index of node in its parent's children is kept by binding
+       (updated by children mutations, so inserting or removing child is
+       O(following siblings count)). For full-tree walks 'TreeIter' is still
+       cheaper - it keeps children indices in its stack.
+    */
+    /* bool */ int taffy_Taffy_parent(
+        const taffy_Taffy* self,
+
+        taffy_NodeId node, taffy_NodeId* out_node
+    );
+
+    /* bool */ int taffy_Taffy_next_sibling(
+        const taffy_Taffy* self,
+
+        taffy_NodeId node, taffy_NodeId* out_node
+    );
+
+    /* bool */ int taffy_Taffy_prev_sibling(
+        const taffy_Taffy* self,
+
+        taffy_NodeId node, taffy_NodeId* out_node
+    );
+
+        /* TreeIter --------------------------------------------------------- */
+
+        /*
+            Allocation-free depth-first iterator. Its stack is provided by the
+            caller (typically - array on the C stack), so iterator itself may
+            be placed on the stack too:
+
+                taffy_TreeIter_Frame frames[64];
+                taffy_TreeIter       iter;
+                taffy_NodeId         node;
+                size_t               depth;
+
+                taffy_TreeIter_init(&iter, tree, root, taffy_TreeIter_Order_PreOrder, frames, 64);
+                while( taffy_TreeIter_next(&iter, &node, &depth) ) {
+                    ...
+                }
+                if( taffy_TreeIter_overflowed(&iter) ) {
+                    ... tree is deeper than 64 levels ...
+                }
+
+            Tree must not be modified during iteration.
+        */
+
+        typedef enum {
+            taffy_TreeIter_Order_PreOrder = 0,
+            taffy_TreeIter_Order_PostOrder
+        } taffy_TreeIter_Order;
+
+        typedef struct {
+            taffy_NodeId node;
+            size_t       child_index; /* next child to visit */
+        } taffy_TreeIter_Frame;
+
+        /* Fields are private - use functions below */
+        typedef struct {
+            const taffy_Taffy*    tree;
+            taffy_TreeIter_Order  order;
+            taffy_TreeIter_Frame* stack;
+            size_t                stack_capacity;
+            size_t                stack_size;
+            /* bool */ int        overflow;
+        } taffy_TreeIter;
+
+        void taffy_TreeIter_init(
+            taffy_TreeIter* self,
+
+            const taffy_Taffy* tree, taffy_NodeId root, taffy_TreeIter_Order order,
+            taffy_TreeIter_Frame* stack, size_t stack_capacity
+        );
+
+        /* Returns 0 (false) when iteration finished (or stack overflowed).
+           'out_node' and 'out_depth' may be null.
+        */
+        /* bool */ int taffy_TreeIter_next(taffy_TreeIter* self, taffy_NodeId* out_node, size_t* out_depth);
+
+        /* pre-order only: dont descend into children of the last returned node */
+        void taffy_TreeIter_skip_children(taffy_TreeIter* self);
+
+        /* bool */ int taffy_TreeIter_overflowed(const taffy_TreeIter* self);
+
+    /* Reconciler ----------------------------------------------------------- */
+
+    /*
+        Keyed tree reconciliation: takes a full (flattened) description of the
+        desired tree and applies to the bound 'taffy_Taffy' only the mutations,
+        needed to reach it (new/removed nodes, changed styles, changed children
+        lists). Nodes and subtrees, that not changed, keep their layout cache.
+
+        Description rules:
+            - 'items[0]' is the root, its 'parent_key' is ignored.
+            - each other item must reference an earlier item as parent.
+            - keys must be unique within a single description.
+            - children order is the order of items in the description.
+
+        Nodes, created by reconciler, are owned by it: node, which key is
+        missing in the next description, is removed from the tree.
+    */
+
+        /* ReconcileItem ---------------------------------------------------- */
+
+        typedef struct {
+            uint64_t key;
+            uint64_t parent_key;
+
+            const taffy_Style* style;
+        } taffy_ReconcileItem;
+
+    typedef struct taffy_Reconciler taffy_Reconciler;
+
+    /* constructors */
+    taffy_Reconciler* taffy_Reconciler_new(taffy_Taffy* tree);
+
+    /* destructor (created nodes stay in the tree) */
+    void taffy_Reconciler_delete(taffy_Reconciler* self);
+
+    /* methods */
+
+    /* On success - returns root node. On invalid description - returns
+       'InvalidParentNode' (unknown/forward parent key) or 'InvalidInputNode'
+       (duplicated key, null style) error with 'child_index' set to offending
+       item index, and tree left untouched.
+    */
+    taffy_TaffyResult_of_NodeId taffy_Reconciler_reconcile(
+        taffy_Reconciler* self,
+
+        const taffy_ReconcileItem* items, size_t items_count
+    );
+
+    /* bool */ int taffy_Reconciler_find(
+        const taffy_Reconciler* self,
+
+        uint64_t key, taffy_NodeId* out_node
+    );
+
+    /* removes all nodes, created by reconciler, from the tree */
+    void taffy_Reconciler_clear(taffy_Reconciler* self);
+
+    /* TreeBuilder ---------------------------------------------------------- */
+
+    /*
+        Streaming (SAX-like) tree construction: each 'begin_node()' creates a
+        node, 'end_node()' closes it and attaches all its children at once
+        (single 'set_children' per node, so building is O(nodes)). Until
+        closed, node is not attached to its parent. Children of open nodes
+        are buffered, one buffer per depth (reused by next nodes, so no
+        allocations once the deepest level is reached).
+
+        Usage:
+            taffy_TreeBuilder_begin_node(b, root_style);
+                taffy_TreeBuilder_begin_node(b, child_style);
+                taffy_TreeBuilder_end_node(b);
+            taffy_TreeBuilder_end_node(b);
+            root = taffy_TreeBuilder_finish(b);
+    */
+
+    typedef struct taffy_TreeBuilder taffy_TreeBuilder;
+
+    /* constructors */
+    taffy_TreeBuilder* taffy_TreeBuilder_new(taffy_Taffy* tree);
+
+    /* destructor (created nodes stay in the tree) */
+    void taffy_TreeBuilder_delete(taffy_TreeBuilder* self);
+
+    /* methods */
+
+    /* 'InvalidInputNode' error - if root node already closed */
+    taffy_TaffyResult_of_NodeId taffy_TreeBuilder_begin_node(
+        taffy_TreeBuilder* self,
+
+        const taffy_Style* style
+    );
+
+    /* 'InvalidInputNode' error - if no open node */
+    taffy_TaffyResult_of_void taffy_TreeBuilder_end_node(taffy_TreeBuilder* self);
+
+    /* Returns root and resets builder for reuse. 'InvalidInputNode' error - if
+       some nodes still open, or no nodes was built.
+    */
+    taffy_TaffyResult_of_NodeId taffy_TreeBuilder_finish(taffy_TreeBuilder* self);
+
+    /* current nesting depth (count of open nodes) */
+    size_t taffy_TreeBuilder_depth(const taffy_TreeBuilder* self);
+
+    /* ThreadPool ----------------------------------------------------------- */
+
+    /*
+        Work-stealing pool of worker threads. Calling thread participates in
+        work too, so pool with 0 worker threads runs everything serially.
+    */
+
+    typedef struct taffy_ThreadPool taffy_ThreadPool;
+
+    /* constructors */
+    taffy_ThreadPool* taffy_ThreadPool_new(size_t threads_count);
+    taffy_ThreadPool* taffy_ThreadPool_new_default(void); /* hardware concurrency - 1 workers */
+
+    /* destructor */
+    void taffy_ThreadPool_delete(taffy_ThreadPool* self);
+
+    /* getters */
+    size_t taffy_ThreadPool_threads_count(const taffy_ThreadPool* self);
+
+    /*
+        Computes layouts of independent trees in parallel: 'results[i]' is
+        result of 'compute_layout(trees[i], roots[i], available_spaces[i])'.
+
+        Each tree computed entirely by single thread, so results are the same
+        for any threads count. All 'trees' must be distinct. Measure functions
+        of different trees may be called concurrently. Null 'pool' - computes
+        all trees on calling thread. Asynchronous computations of 'trees' are
+        waited for and their published layouts dropped first (on calling
+        thread), as by 'taffy_Taffy_compute_layout()'.
+    */
+    void taffy_compute_layouts_parallel(
+        taffy_Taffy* const*                        trees,
+        const taffy_NodeId*                        roots,
+        const taffy_Size_of_AvailableSpace* const* available_spaces,
+        size_t                                     count,
+
+        taffy_ThreadPool*          pool,
+        taffy_TaffyResult_of_void* results
+    );
+
+    /*
+        Intra-tree parallel layout (opt-in, null 'pool' - disables it).
+
+        Before layout of the whole tree, dirty independent subtrees laid out
+        concurrently on 'pool', then usual serial layout reuses their cached
+        results - so result is identical to serial layout. Subtree is
+        independent, if its root has Length padding and border and either
+        fixed size (detected relayout boundary, see 'taffy_Taffy_set_relayout_boundary()'),
+        or explicitly hinted by 'taffy_Taffy_set_parallel_hint()'. Subtrees
+        with less than 'min_subtree_nodes' nodes are skipped, as well as ones
+        with measure functions - unless they are declared thread-safe by
+        'taffy_Taffy_set_parallel_measure()'.
+
+        Not used in batch measure mode. Relies on taffy_cpp computing disjoint
+        subtrees of one tree concurrently (true for its current implementation,
+        not documented by it). Measure functions must not mutate the tree
+        (asserted).
+    */
+    void taffy_Taffy_set_parallel_layout(
+        taffy_Taffy* self,
+
+        taffy_ThreadPool* pool, size_t min_subtree_nodes
+    );
+
+    /* Measure functions are thread-safe: subtrees with them may be laid out
+       on pool threads, and functions of different subtrees called
+       concurrently. Disabled by default - such subtrees laid out by serial
+       pass (fixed text nodes are measured by binding - always allowed).
+    */
+    void taffy_Taffy_set_parallel_measure(taffy_Taffy* self, /* bool */ int thread_safe);
+
+    /* Hint: layout of node depends only on its own size (not on parent), so
+       its subtree may be laid out independently, at its previous (unrounded)
+       size. Ignored for nodes with percentage padding or border.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_set_parallel_hint(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, /* bool */ int hint
+    );
+
+    /* Time-budgeted layout ------------------------------------------------- */
+
+    typedef struct {
+        /* bool */ int done;
+        float progress; /* [0 .. 1] */
+    } taffy_LayoutStep;
+
+    /*
+        Lays out the tree incrementally, spending about 'budget_ns' nanoseconds
+        per call. Dirty independent subtrees - fixed size or hinted ones (see
+        'taffy_Taffy_set_parallel_hint()') - are laid out first, deepest first,
+        one per unit of work; then the whole tree in the last call, taking
+        their results from cache. Budget bounds only these units: at least one
+        unit done per call, and the last call lays out the whole tree, so a
+        call may overrun budget by one whole-tree pass. Tree without
+        independent subtrees is laid out by the first call.
+
+        Until 'step->done', 'taffy_Taffy_layout()' (and 'taffy_Taffy_acquire_layouts()')
+        returns layouts from before the first step, published as by
+        'taffy_Taffy_compute_layout_async()' - copied once per (re)start.
+        Live layouts are not consistent in between: subtrees are laid out as
+        roots, at 0, 0.
+
+        Call it (with the same 'root' and 'available_space') every frame until
+        'step->done' - then layouts are the same as after 'taffy_Taffy_compute_layout()'.
+        Computation restarts by itself if the tree was mutated or called with
+        other 'root' or 'available_space' - already laid out clean subtrees
+        are not laid out again. Layout changes (see 'taffy_Taffy_set_track_layout_changes()')
+        made by steps before restart or abandon are reported by the next
+        finished computation.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_compute_layout_step(
+        taffy_Taffy* self,
+
+        taffy_NodeId root,
+        const taffy_Size_of_AvailableSpace* available_space,
+        uint64_t budget_ns,
+        taffy_LayoutStep* step
+    );
+
+    /* drops state of in-progress 'taffy_Taffy_compute_layout_step()' ('taffy_Taffy_layout()'
+       still returns layouts from before its first step - until the next layout)
+    */
+    void taffy_Taffy_compute_layout_abandon(taffy_Taffy* self);
+
+    /* Asynchronous layout -------------------------------------------------- */
+
+    /* called on worker thread, after results published (or on calling
+       thread - if 'root' is invalid). Only 'taffy_Taffy_layout()' may be
+       called on the tree from it.
+    */
+    typedef void (*taffy_LayoutDoneFunc)(
+        taffy_Taffy* tree, taffy_NodeId root, taffy_TaffyResult_of_void result, void* user_data
+    );
+
+    /*
+        Lays out the tree on worker thread (one per tree, started by the first
+        call). Results (for subtree of 'root') are copied into new buffer of
+        layouts and atomically published, then 'on_done' (if not null) called.
+
+        Since the call 'taffy_Taffy_layout()' returns layouts from the last
+        published buffer (at first - copy of current layouts) - without locks,
+        from any thread, also during computation. Nodes not in it (outside of
+        subtree of 'root', or created after publication) - from live layouts,
+        after computation finished (waits for it). Returned pointers stay
+        valid until the next 'taffy_Taffy_compute_layout_async()' call or
+        synchronous layout (which drops published buffer - back to live
+        layouts); to keep them longer - see 'taffy_Taffy_acquire_layouts()'.
+
+        Previous computation is waited for. Mutating functions (also of
+        reconciler and tree builder) wait for computation too. Until it is
+        finished, the tree must not be used on other threads, except
+        'taffy_Taffy_layout()' and 'taffy_Taffy_acquire_layouts()' - and live
+        layouts may be read from other threads only while the tree is not
+        mutated. Functions, which report results of computation (dirty nodes,
+        layout changes, damage rects, generations, etc), wait for it too.
+        Measure functions called on worker thread.
+    */
+    void taffy_Taffy_compute_layout_async(
+        taffy_Taffy* self,
+
+        taffy_NodeId root,
+        const taffy_Size_of_AvailableSpace* available_space,
+        taffy_LayoutDoneFunc on_done, void* user_data
+    );
+
+    /*
+        Waits for the current asynchronous computation (if any), returns the
+        result of the last one. Must not be called from 'on_done'.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_compute_layout_wait(taffy_Taffy* self);
+
+    /* Buffer of layouts, published by asynchronous computation */
+    typedef struct taffy_PublishedLayouts taffy_PublishedLayouts;
+
+    /*
+        Returns the last published buffer with reference owned by caller
+        (release it by 'taffy_PublishedLayouts_release()'), or null if there
+        is none (no asynchronous computation since the last synchronous
+        layout). Any thread, also during computation.
+
+        Acquired buffer is immutable and stays valid until released - also
+        after the next publication or deletion of the tree, so render thread
+        may draw the previous result while the next one is computed.
+    */
+    taffy_PublishedLayouts* taffy_Taffy_acquire_layouts(const taffy_Taffy* self);
+
+    /* adds reference, returns 'self' */
+    taffy_PublishedLayouts* taffy_PublishedLayouts_retain(taffy_PublishedLayouts* self);
+
+    /* drops reference, the last one deletes buffer */
+    void taffy_PublishedLayouts_release(taffy_PublishedLayouts* self);
+
+    /* error ('InvalidInputNode') - node is not in buffer */
+    taffy_TaffyResult_of_Layout_const_ref taffy_PublishedLayouts_layout(
+        const taffy_PublishedLayouts* self,
+
+        taffy_NodeId node
+    );
+
+    /* LayoutSnapshot ------------------------------------------------------- */
+
+    /*
+        Immutable, reference-counted copy of layouts of the tree, laid out by
+        the last layout computation (and of other roots, laid out before).
+        Safe to read from any thread without synchronisation, regardless of
+        what happens with the tree.
+    */
+    typedef struct taffy_LayoutSnapshot taffy_LayoutSnapshot;
+
+    /*
+        Returns snapshot with reference owned by caller (release it by
+        'taffy_LayoutSnapshot_release()'). While layouts not changed (no
+        layout computations and no mutations), all snapshots share the same
+        copy. Otherwise new copy made: layouts are compared with the previous
+        snapshot - O(n) in laid out nodes count, no per-node allocations - and
+        only chunks of 64 node slots with changed layouts are allocated, the
+        rest are shared with it.
+
+        Blocks: waits for asynchronous computation (if any) to finish.
+    */
+    taffy_LayoutSnapshot* taffy_Taffy_snapshot(taffy_Taffy* self);
+
+    /* adds reference, returns 'self' */
+    taffy_LayoutSnapshot* taffy_LayoutSnapshot_retain(taffy_LayoutSnapshot* self);
+
+    /* drops reference, the last one deletes snapshot */
+    void taffy_LayoutSnapshot_release(taffy_LayoutSnapshot* self);
+
+    /* root of laid out tree ('id' == 0 if nothing was laid out) */
+    taffy_NodeId taffy_LayoutSnapshot_root(const taffy_LayoutSnapshot* self);
+
+    size_t taffy_LayoutSnapshot_nodes_count(const taffy_LayoutSnapshot* self);
+
+    taffy_TaffyResult_of_Layout_const_ref taffy_LayoutSnapshot_layout(
+        const taffy_LayoutSnapshot* self,
+
+        taffy_NodeId node
+    );
+
+    /* Layout changes ------------------------------------------------------- */
+
+    typedef struct {
+        float x;
+        float y;
+        float width;
+        float height;
+    } taffy_LayoutRect;
+
+    typedef struct {
+        taffy_NodeId node;
+
+        /* rects, relative to parent */
+        taffy_LayoutRect previous;
+        taffy_LayoutRect current;
+    } taffy_LayoutChange;
+
+    typedef struct {
+        const taffy_LayoutChange* items;
+        size_t                    items_count;
+    } taffy_LayoutChanges;
+
+    /*
+        Enables report of nodes, which layouts (location or size) changed by
+        layout computation. Disabled by default.
+
+        Layouts are compared against the last ones seen by tracking. When the
+        same root laid out again, only subtrees of dirty nodes and of nodes,
+        which layouts changed, are checked; otherwise the whole laid out tree.
+    */
+    void taffy_Taffy_set_track_layout_changes(taffy_Taffy* self, /* bool */ int enabled);
+
+    /*
+        Nodes changed by the last layout computation (any: synchronous, async -
+        after it is finished, last step of time-budgeted one, multi-viewport -
+        final layouts against the layouts before it).
+
+        Borrowed: valid until the next layout computation.
+    */
+    taffy_LayoutChanges taffy_Taffy_changed_layouts(const taffy_Taffy* self);
+
+    /*
+        Enables per-node layout generations: generation of node is value of
+        tree-global monotonic counter, taken by the last layout computation,
+        which changed its layout (location or size). Generations are never
+        repeated, also after node removed. Layouts compared the same way, as
+        for 'taffy_Taffy_set_track_layout_changes()' - nodes, resized or moved
+        by changes elsewhere, get new generation too. Disabled by default.
+    */
+    void taffy_Taffy_set_track_layout_generations(taffy_Taffy* self, /* bool */ int enabled);
+
+    /* 0 - layout never changed while generations tracked (or invalid node).
+       Waits for asynchronous computation (if any).
+    */
+    uint64_t taffy_Taffy_layout_generation(const taffy_Taffy* self, taffy_NodeId node);
+
+    void taffy_Taffy_layout_generations(
+        const taffy_Taffy* self,
+
+        const taffy_NodeId* nodes, size_t count, uint64_t* out_generations
+    );
+
+    /*
+        Rects, invalidated by the last layout computation: previous and current
+        bounds of changed nodes in subtree of 'root' (see 'taffy_Taffy_changed_layouts()'),
+        relative to root's parent, merged into at most 'max_rects' rects.
+        Rects are merged while it adds no area (contained ones, etc), and
+        while there are too many - ones with the least added area (for many
+        rects - first neighbours in rows order, pairwise). Returns count of
+        written rects.
+
+        NOTE: descendants of moved node are assumed to be inside its bounds.
+    */
+    size_t taffy_Taffy_damage_rects(
+        taffy_Taffy* self,
+
+        taffy_NodeId root, taffy_LayoutRect* out_rects, size_t max_rects
+    );
+
+    /* Virtual list --------------------------------------------------------- */
+
+    /* height of row 'index' */
+    typedef float (*taffy_RowSizeFunc)(size_t index, void* user_data);
+
+    /*
+        Virtual list - vertical list container with 'rows_count' rows, of which
+        only visible window is materialized as real nodes (see
+        'taffy_Taffy_virtual_list_set_window()'), so cost depends on window
+        size, not on rows count.
+
+        Rows heights: 'row_size_func(index)' if not null (called once per row
+        on first use - then kept in Fenwick tree, so offsets, row search and
+        invalidation of single rows are O(log n)), otherwise uniform
+        'row_size'. List content height is the sum of them (given by internal
+        spacer child, which is the first child of the list).
+
+        Removed by 'taffy_Taffy_remove()' together with spacer, but not with
+        window rows.
+    */
+    taffy_TaffyResult_of_NodeId taffy_Taffy_new_virtual_list(
+        taffy_Taffy* self,
+
+        const taffy_Style* style,
+        size_t rows_count, float row_size, taffy_RowSizeFunc row_size_func, void* user_data
+    );
+
+    /* changes rows, call 'taffy_Taffy_virtual_list_set_window()' after */
+    taffy_TaffyResult_of_void taffy_Taffy_virtual_list_set_rows(
+        taffy_Taffy* self,
+
+        taffy_NodeId node,
+        size_t rows_count, float row_size, taffy_RowSizeFunc row_size_func, void* user_data
+    );
+
+    /* Heights of rows 'first_row' .. 'first_row + rows_count' changed (called
+       again for them, O(log n) each), call 'taffy_Taffy_virtual_list_set_window()'
+       after.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_virtual_list_invalidate_rows(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, size_t first_row, size_t rows_count
+    );
+
+    /*
+        Makes 'rows' (nodes, owned by caller) children of the list, for rows
+        'first_row' .. 'first_row + rows_count'. Their styles are changed:
+        absolute position at row offset, stretched horizontally, with row
+        height. Rows of previous window, not passed again, are detached.
+    */
+    taffy_TaffyResult_of_void taffy_Taffy_virtual_list_set_window(
+        taffy_Taffy* self,
+
+        taffy_NodeId node,
+        size_t first_row, const taffy_NodeId* rows, size_t rows_count
+    );
+
+    /*
+        Index of row at vertical 'offset' in list content (for example, scroll
+        offset) - 'rows_count' if after the last row. Window for viewport is
+        'row_at(scroll)' .. 'row_at(scroll + viewport height) + 1'.
+    */
+    taffy_TaffyResult_of_size_t taffy_Taffy_virtual_list_row_at(
+        taffy_Taffy* self,
+
+        taffy_NodeId node, float offset
+    );
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
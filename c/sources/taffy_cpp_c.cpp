@@ -4,7 +4,29 @@
 
 // -----------------------------------------------------------------------------
 
+#include <algorithm> // for: std::sort(), std::unique(), std::upper_bound(), std::equal()
+#include <atomic> // for: std::atomic<T>
 #include <cassert> // for: assert()
+#include <chrono> // for: std::chrono::steady_clock
+#include <cmath> // for: std::round(), std::floor()
+#include <condition_variable> // for: std::condition_variable
+#include <functional> // for: std::function<F>
+#include <memory> // for: std::unique_ptr<T>, std::shared_ptr<T>
+#include <mutex> // for: std::mutex, std::lock_guard<T>, std::unique_lock<T>
+#include <thread> // for: std::thread
+#include <unordered_map> // for: std::unordered_map<K, V>
+#include <vector> // for: std::vector<T>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define TAFFY_C_ROUNDING_SSE2
+    #include <emmintrin.h> // for: __m128, _mm_*()
+
+    // AVX2 code compiled by function attribute, selected at runtime
+    #if defined(__GNUC__) || defined(__clang__)
+        #define TAFFY_C_ROUNDING_AVX2
+        #include <immintrin.h> // for: __m256, _mm256_*()
+    #endif
+#endif
 
 #define ASSERT_NOT_NULL(pointer) \
     assert(pointer != nullptr)
@@ -3920,343 +3942,6387 @@ taffy_TaffyResult_of_Layout_const_ref taffy_TaffyResult_of_Layout_const_ref_from
     return ret;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Results, made on binding side
+
+static taffy_TaffyResult_of_void taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type type, size_t child_index, size_t child_count)
+{
+    taffy_TaffyResult_of_void ret;
+
+    ret.error.type = type;
+
+    ret.error.node.id     = 0;
+    ret.error.child_index = child_index;
+    ret.error.child_count = child_count;
+
+    return ret;
+}
+
+static taffy_TaffyResult_of_void taffy_TaffyResult_of_void_from_cpp_error(const taffy::TaffyError& error)
+{
+    taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_from_cpp(error.type()), error.child_index(), error.child_count());
+    ret.error.node.id = static_cast<uint64_t>( error.node() );
+
+    return ret;
+}
+
+static taffy_TaffyResult_of_void taffy_TaffyResult_of_void_make_ok(void)
+{
+    taffy_TaffyResult_of_void ret;
+
+    ret.error.type = taffy_TaffyError_Type_Ok;
+
+    ret.error.node.id     = 0;
+    ret.error.child_index = 0;
+    ret.error.child_count = 0;
+
+    return ret;
+}
+
+static taffy_TaffyResult_of_NodeId taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type type, size_t child_index, size_t child_count)
+{
+    taffy_TaffyResult_of_NodeId ret;
+
+    ret.error.type = type;
+
+    ret.error.node.id     = 0;
+    ret.error.child_index = child_index;
+    ret.error.child_count = child_count;
+
+    ret.value.id = 0;
+
+    return ret;
+}
+
+static taffy_TaffyResult_of_NodeId taffy_TaffyResult_of_NodeId_from_cpp_error(const taffy::TaffyError& error)
+{
+    taffy_TaffyResult_of_NodeId ret = taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type_from_cpp(error.type()), error.child_index(), error.child_count());
+    ret.error.node.id = static_cast<uint64_t>( error.node() );
+
+    return ret;
+}
+
+static taffy_TaffyResult_of_NodeId taffy_TaffyResult_of_NodeId_make_ok(const taffy::NodeId& node)
+{
+    taffy_TaffyResult_of_NodeId ret;
+
+    ret.error.type = taffy_TaffyError_Type_Ok;
+
+    ret.error.node.id     = 0;
+    ret.error.child_index = 0;
+    ret.error.child_count = 0;
+
+    ret.value.id = static_cast<uint64_t>(node);
+
+    return ret;
+}
+
+static bool taffy_NodeId_eq(const taffy::NodeId& lhs, const taffy::NodeId& rhs)
+{
+    return static_cast<uint64_t>(lhs) == static_cast<uint64_t>(rhs);
+}
+
+// NodeId is a slot map key: '(version << 32) | index', where 'index' is the
+// node's slot in the tree storage - so it may index dense per-node arrays
+static size_t taffy_NodeId_slot(const taffy::NodeId& node)
+{
+    return static_cast<size_t>( static_cast<uint64_t>(node) & 0xFFFFFFFFu );
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+/*
+    Binding-side C++ types (not present in 'taffy_cpp' itself) live in the
+    'taffy_c' namespace, and are exposed to C via opaque pointers, the same way
+    as 'taffy' types.
+*/
+namespace taffy_c {
+
+// Measure function input with its result
+struct MeasureEntry
+{
+    taffy_MeasureKnownDimensions known_dimensions;
+    taffy_MeasureAvailableSpace  available_space;
+    taffy_MeasureSize            size;
+};
+
+// Built-in fixed-metrics text measure data (see 'taffy_FixedText')
+struct FixedText
+{
+    size_t               glyph_count;
+    float                advance;
+    float                line_height;
+    taffy_FixedText_Wrap wrap;
+
+    std::vector<size_t> breaks;   // sorted, unique, in (0, glyph_count) range
+    size_t              max_word; // longest unbreakable run (min-content width, in glyphs)
+
+    FixedText()
+        : glyph_count(0)
+        , advance(0.0f)
+        , line_height(0.0f)
+        , wrap(taffy_FixedText_Wrap_None)
+        , breaks()
+        , max_word(0)
+    {}
+};
+
+/*
+    Virtual list data (see 'taffy_Taffy_new_virtual_list()'). Rows offsets
+    (prefix sums of rows sizes) computed lazily and kept in double, since
+    float loses whole pixels on long lists.
+*/
+struct VirtualList
+{
+    uint64_t spacer; // child, which gives list its content height
+
+    size_t            rows_count;
+    float             row_size; // if no 'row_size_func'
+    taffy_RowSizeFunc row_size_func;
+    void*             row_size_user_data;
+
+    // Rows sizes (if 'row_size_func'), fetched all at once on first use, and
+    // Fenwick tree over them: offsets (prefix sums), row search and updates
+    // of single rows in O(log n)
+    std::vector<double> sizes;
+    std::vector<double> sums; // 1-based, 'rows_count + 1' items
+    bool                built;
+
+    VirtualList()
+        : spacer(0)
+        , rows_count(0)
+        , row_size(0.0f)
+        , row_size_func(nullptr)
+        , row_size_user_data(nullptr)
+        , sizes()
+        , sums()
+        , built(false)
+    {}
+
+    void set_rows(size_t count, float size, taffy_RowSizeFunc func, void* user_data)
+    {
+        rows_count         = count;
+        row_size           = size;
+        row_size_func      = func;
+        row_size_user_data = user_data;
+
+        built = false;
+    }
+
+    // O(n): each node of Fenwick tree added once to its parent
+    void build()
+    {
+        sizes.resize(rows_count);
+        sums.assign(rows_count + 1, 0.0);
+
+        for(size_t i = 0; i < rows_count; ++i)
+        {
+            sizes[i]    = static_cast<double>( row_size_func(i, row_size_user_data) );
+            sums[i + 1] = sizes[i];
+        }
+        for(size_t i = 1; i <= rows_count; ++i)
+        {
+            const size_t parent = i + (i & (~i + 1));
+            if(parent <= rows_count) {
+                sums[parent] += sums[i];
+            }
+        }
+
+        built = true;
+    }
+
+    void ensure_built()
+    {
+        if(!built) {
+            build();
+        }
+    }
+
+    double offset(size_t index) // index <= rows_count
+    {
+        if(row_size_func == nullptr) {
+            return static_cast<double>(index) * static_cast<double>(row_size);
+        }
+        ensure_built();
+
+        double sum = 0.0;
+        for(size_t i = index; i > 0; i -= (i & (~i + 1))) {
+            sum += sums[i];
+        }
+        return sum;
+    }
+
+    float size(size_t index)
+    {
+        if(row_size_func == nullptr) {
+            return row_size;
+        }
+        ensure_built();
+
+        return static_cast<float>(sizes[index]);
+    }
+
+    double total()
+    {
+        return offset(rows_count);
+    }
+
+    // Index of row, containing 'position' (clamped to [0, rows_count])
+    size_t row_at(double position)
+    {
+        if(position <= 0.0) {
+            return 0;
+        }
+
+        if(row_size_func == nullptr)
+        {
+            if(row_size <= 0.0f) {
+                return 0;
+            }
+            const double index = std::floor( position / static_cast<double>(row_size) );
+            return (index < static_cast<double>(rows_count)) ? static_cast<size_t>(index) : rows_count;
+        }
+        ensure_built();
+
+        // Descent: the last rows count, which offset <= position
+        size_t step = 1;
+        while( (step << 1) <= rows_count ) {
+            step <<= 1;
+        }
+
+        size_t count = 0;
+        double rest  = position;
+        for(; step > 0; step >>= 1)
+        {
+            if( (count + step <= rows_count) && (sums[count + step] <= rest) )
+            {
+                count += step;
+                rest  -= sums[count];
+            }
+        }
+        return count;
+    }
+
+    // Sizes of rows 'first' .. 'first + count' fetched again
+    void invalidate(size_t first, size_t count)
+    {
+        if( !built || (first >= rows_count) ) {
+            return;
+        }
+        if(count > rows_count - first) {
+            count = rows_count - first;
+        }
+
+        // Many rows - cheaper to build again (lazily)
+        if(count > rows_count / 16)
+        {
+            built = false;
+            return;
+        }
+
+        for(size_t row = first; row < first + count; ++row)
+        {
+            const double size  = static_cast<double>( row_size_func(row, row_size_user_data) );
+            const double delta = size - sizes[row];
+            sizes[row] = size;
+
+            for(size_t i = row + 1; i <= rows_count; i += (i & (~i + 1))) {
+                sums[i] += delta;
+            }
+        }
+    }
+};
+
+// Per-node data, for which 'taffy::Taffy' nodes have no place
+struct NodeData
+{
+    uint64_t id;
+
+    void* context;
+
+    taffy_MeasureFunc measure;
+    void*             measure_user_data;
+
+    std::unique_ptr<FixedText> fixed_text; // set instead of 'measure'
+
+    std::unique_ptr<VirtualList> virtual_list; // see 'taffy_Taffy_new_virtual_list()'
+
+    bool parallel_hint;     // see 'taffy_Taffy_set_parallel_hint()'
+    bool relayout_boundary; // see 'taffy_Taffy_set_relayout_boundary()'
+
+    // Measure results cache (see 'MeasureCache')
+    std::vector<MeasureEntry> measure_cache;
+    size_t                    measure_cache_next; // next entry to evict
+
+    // Batch measure results (and pending requests), valid during single
+    // 'compute_layout()' call
+    std::vector<MeasureEntry> batch_results;
+    size_t                    batch_pending; // count of pending entries (at end of 'batch_results')
+
+
+    NodeData()
+        : id(0)
+        , context(nullptr)
+        , measure(nullptr)
+        , measure_user_data(nullptr)
+        , fixed_text()
+        , virtual_list()
+        , parallel_hint(false)
+        , relayout_boundary(false)
+        , measure_cache()
+        , measure_cache_next(0)
+        , batch_results()
+        , batch_pending(0)
+    {}
+};
+
+/*
+    Per-node measure results cache config and statistics.
+
+    Taffy calls measure functions repeatedly with the same inputs across
+    layout passes (and its own per-node cache is dropped on any change in
+    subtree), so results cached on binding side, with up to 'capacity' entries
+    per node, evicted in FIFO order. Inputs are matched with 'tolerance'.
+*/
+struct MeasureCache
+{
+    size_t capacity; // 0 - disabled
+    float  tolerance;
+
+    // NOTE: atomic, since measure may happen concurrently (in parallel layout)
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> evictions;
+
+    MeasureCache()
+        : capacity(0)
+        , tolerance(0.0f)
+        , hits(0)
+        , misses(0)
+        , evictions(0)
+    {}
+};
+
+/*
+    Batch measure mode state.
+
+    Taffy needs measure result immediately, so batching done in rounds: layout
+    computed with provisional results for unknown measure inputs (while their
+    requests collected), then all collected requests measured by single batch
+    call, affected leaves marked dirty, and layout recomputed - until no new
+    requests appear. Requests are ordered by first occurrence during layout,
+    which is deterministic.
+*/
+struct BatchMeasure
+{
+    static constexpr size_t MAX_ROUNDS = 8;
+
+    taffy_BatchMeasureFunc func;
+    void*                  user_data;
+
+    // If rounds not converged - last round measures each request immediately
+    bool synchronous;
+
+    std::vector<taffy_MeasureRequest> requests; // pending requests of current round
+    std::vector<taffy_MeasureSize>    results;
+    std::vector<NodeData*>            requesters; // request index -> node data
+    std::vector<NodeData*>            measured;   // nodes with 'batch_results', to clear them after computation
+
+    BatchMeasure()
+        : func(nullptr)
+        , user_data(nullptr)
+        , synchronous(false)
+        , requests()
+        , results()
+        , requesters()
+        , measured()
+    {}
+};
+
+class ThreadPool;
+
+// Intra-tree parallel layout config and scratch data
+struct ParallelLayout
+{
+    struct Unit
+    {
+        taffy::NodeId                      node;
+        taffy::Size<taffy::AvailableSpace> available_space;
+    };
+
+    ThreadPool* pool; // null - disabled
+    size_t      min_subtree_nodes;
+    bool        concurrent_measure; // see 'taffy_Taffy_set_parallel_measure()'
+
+    std::vector<Unit>          units;
+    std::vector<taffy::NodeId> walk;
+    std::vector<taffy::NodeId> stack;
+
+    ParallelLayout()
+        : pool(nullptr)
+        , min_subtree_nodes(0)
+        , concurrent_measure(false)
+        , units()
+        , walk()
+        , stack()
+    {}
+};
+
+/*
+    Relayout boundaries state.
+
+    Taffy propagates dirtiness up to the root, so binding records origins of
+    changes: node itself changed (style, measure), or only its content
+    (children list). If each change is inside of relayout boundary - node,
+    which size not depends on its content - only subtrees of such boundaries
+    laid out again, at their previous sizes.
+*/
+struct Relayout
+{
+    static constexpr size_t MAX_CHANGES = 1024; // more changes - whole tree laid out
+
+    enum class Change { Self, Content };
+
+    struct Record
+    {
+        taffy::NodeId node;
+        Change        change;
+    };
+
+    std::vector<Record> changes;
+    bool                full; // unknown changes (or too many) - whole tree must be laid out
+
+    // Previous layout computation (boundaries relayout valid only for the same)
+    bool                               computed;
+    uint64_t                           root;
+    taffy::Size<taffy::AvailableSpace> available_space;
+
+    std::vector<uint64_t> boundaries; // scratch
+
+    // Available space of each laid out root (last one)
+    std::unordered_map<uint64_t, taffy::Size<taffy::AvailableSpace>> root_spaces;
+
+    // Settled nodes: ancestors of boundaries, laid out again in place (and
+    // such boundaries themselves). Taffy still marks them dirty, but their
+    // layouts are up to date - until next change inside of them, or full
+    // layout. Node id by node slot (0 - not settled).
+    std::vector<uint64_t> settled;
+    size_t                settled_count;
+
+    uint64_t mutations; // count of recorded changes (including not stored)
+
+    Relayout()
+        : changes()
+        , full(true)
+        , computed(false)
+        , root(0)
+        , available_space{ taffy::AvailableSpace::MaxContent(), taffy::AvailableSpace::MaxContent() }
+        , boundaries()
+        , root_spaces()
+        , settled()
+        , settled_count(0)
+        , mutations(0)
+    {}
+
+    bool is_settled(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        return (slot < settled.size()) && (settled[slot] == static_cast<uint64_t>(node));
+    }
+
+    void settle(const taffy::NodeId& node)
+    {
+        if( is_settled(node) ) {
+            return;
+        }
+
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= settled.size()) {
+            settled.resize(slot + 1, 0);
+        }
+        settled[slot] = static_cast<uint64_t>(node);
+        ++settled_count;
+    }
+
+    void unsettle(const taffy::NodeId& node)
+    {
+        if( !is_settled(node) ) {
+            return;
+        }
+
+        settled[ taffy_NodeId_slot(node) ] = 0;
+        --settled_count;
+    }
+
+    void clear_settled()
+    {
+        if(settled_count == 0) {
+            return;
+        }
+
+        settled.clear();
+        settled_count = 0;
+    }
+
+    void record(const taffy::NodeId& node, Change change)
+    {
+        ++mutations;
+
+        if(full) {
+            return;
+        }
+
+        if(changes.size() >= MAX_CHANGES)
+        {
+            record_all();
+            return;
+        }
+
+        changes.push_back( Record{ node, change } );
+    }
+
+    void record_all()
+    {
+        ++mutations;
+
+        full = true;
+        changes.clear();
+    }
+};
+
+/*
+    Nodes, changed directly since they were laid out (their ancestors are
+    dirty too), in order of change. Laid out ones dropped after each layout
+    computation.
+*/
+struct DirtyNodes
+{
+    struct Entry
+    {
+        taffy::NodeId node;
+        bool          alive; // 'false' - erased (tombstone, dropped by 'compact()')
+    };
+
+    std::vector<Entry>  list;      // in order of change, with tombstones
+    std::vector<size_t> positions; // by node slot: position in 'list' + 1 (0 - not listed)
+    size_t              count;     // of alive entries
+
+    DirtyNodes()
+        : list()
+        , positions()
+        , count(0)
+    {}
+
+    bool contains(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if( (slot >= positions.size()) || (positions[slot] == 0) ) {
+            return false;
+        }
+
+        const Entry& entry = list[ positions[slot] - 1 ];
+        return entry.alive && taffy_NodeId_eq(entry.node, node);
+    }
+
+    void add(const taffy::NodeId& node)
+    {
+        if( contains(node) ) {
+            return;
+        }
+
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= positions.size()) {
+            positions.resize(slot + 1, 0);
+        }
+
+        list.push_back( Entry{ node, true } );
+        positions[slot] = list.size();
+        ++count;
+    }
+
+    void erase(const taffy::NodeId& node)
+    {
+        if( !contains(node) ) {
+            return;
+        }
+
+        const size_t slot = taffy_NodeId_slot(node);
+        list[ positions[slot] - 1 ].alive = false;
+        positions[slot] = 0;
+        --count;
+
+        // Amortized O(1): compacted only when tombstones outnumber alive entries
+        if(list.size() > 2 * count) {
+            retain( [](const taffy::NodeId&) { return true; } );
+        }
+    }
+
+    // Keeps (in order) only alive entries, for which 'keep(node)' is true
+    template <typename Keep>
+    void retain(Keep keep)
+    {
+        size_t kept = 0;
+        for(size_t i = 0; i < list.size(); ++i)
+        {
+            const Entry entry = list[i];
+            if( !entry.alive ) {
+                continue;
+            }
+
+            const size_t slot = taffy_NodeId_slot(entry.node);
+            if( keep(entry.node) ) {
+                list[kept++] = entry;
+                positions[slot] = kept;
+            } else {
+                positions[slot] = 0;
+            }
+        }
+        list.erase(list.begin() + kept, list.end());
+        count = kept;
+    }
+
+    void clear()
+    {
+        list.clear();
+        positions.clear();
+        count = 0;
+    }
+};
+
+// State of in-progress 'taffy_Taffy_compute_layout_step()'
+struct LayoutStepper
+{
+    struct Unit
+    {
+        taffy::NodeId                      node;
+        taffy::Size<taffy::AvailableSpace> available_space;
+    };
+
+    bool                               active;
+    uint64_t                           root;
+    taffy::Size<taffy::AvailableSpace> available_space;
+    uint64_t                           mutations; // 'Relayout::mutations' at start
+
+    std::vector<Unit> units; // deepest first
+    size_t            next;
+
+    std::vector<taffy::NodeId> walk; // scratch
+
+    LayoutStepper()
+        : active(false)
+        , root(0)
+        , available_space{ taffy::AvailableSpace::MaxContent(), taffy::AvailableSpace::MaxContent() }
+        , mutations(0)
+        , units()
+        , next(0)
+        , walk()
+    {}
+
+    void abandon()
+    {
+        active = false;
+        units.clear();
+        next = 0;
+    }
+};
+
+// Layouts of subtree, published by asynchronous computation: immutable once
+// published, so readers use it without locks. Object behind
+// 'taffy_PublishedLayouts' pointer too - reference counted.
+struct LayoutBuffer
+{
+    struct Entry
+    {
+        uint64_t      id; // owner node (slots are reused by new nodes)
+        bool          valid;
+        taffy::Layout layout;
+    };
+    std::vector<Entry> entries; // by node slot
+
+    mutable std::atomic<size_t> references;
+
+    LayoutBuffer()
+        : entries()
+        , references(1)
+    {}
+
+    void retain() const
+    {
+        references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() const
+    {
+        if(references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    const taffy::Layout* find(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= entries.size()) {
+            return nullptr;
+        }
+
+        const Entry& entry = entries[slot];
+        return (entry.valid && (entry.id == static_cast<uint64_t>(node))) ? &entry.layout : nullptr;
+    }
+
+    void store(const taffy::NodeId& node, const taffy::Layout& layout)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= entries.size()) {
+            entries.resize( slot + 1, Entry{ 0, false, taffy::Layout::with_order(0) } );
+        }
+
+        Entry& entry = entries[slot];
+        entry.id     = static_cast<uint64_t>(node);
+        entry.valid  = true;
+        entry.layout = layout;
+    }
+
+    void clear()
+    {
+        for(Entry& entry : entries) {
+            entry.valid = false;
+        }
+    }
+};
+
+/*
+    State of 'taffy_Taffy_compute_layout_async()': persistent worker thread
+    (started by the first call) and published layouts.
+
+    Published buffer is replaced by the next publication, but not reused or
+    deleted while readers may use it: replaced buffers are retired, and
+    reclaimed only at owner thread sync points (next asynchronous call,
+    synchronous layout), if no reader is inside of lookup ('readers'). Buffer
+    acquired by reader (see 'taffy_Taffy_acquire_layouts()') holds its own
+    reference: it is not reused, and deleted by the last release.
+*/
+struct AsyncLayout
+{
+    std::thread     worker;
+    std::thread::id worker_id;
+
+    mutable std::mutex              mutex; // guards all below, except atomics
+    mutable std::condition_variable signal;
+
+    std::function<void()> job; // pending
+    bool                  busy; // job pending or running (including 'on_done')
+    bool                  stopping;
+
+    taffy_TaffyResult_of_void result; // of the last computation
+
+    // References owned by this object
+    LayoutBuffer*              current; // published
+    std::vector<LayoutBuffer*> retired;
+    LayoutBuffer*              spare; // reclaimed, reused by next publication
+
+    std::atomic<const LayoutBuffer*> front; // == 'current', null - live layouts
+    mutable std::atomic<size_t>      readers; // inside of lookup in 'front'
+
+    std::vector<taffy::NodeId> walk; // scratch (of publishing thread)
+
+    AsyncLayout()
+        : worker()
+        , worker_id()
+        , mutex()
+        , signal()
+        , job()
+        , busy(false)
+        , stopping(false)
+        , result( taffy_TaffyResult_of_void_make_ok() )
+        , current(nullptr)
+        , retired()
+        , spare(nullptr)
+        , front(nullptr)
+        , readers(0)
+        , walk()
+    {}
+
+    ~AsyncLayout()
+    {
+        stop();
+
+        // NOTE: acquired buffers deleted by their last release
+        for(LayoutBuffer* buffer : retired) {
+            buffer->release();
+        }
+        if(current) { current->release(); }
+        if(spare)   { spare  ->release(); }
+    }
+
+    // Owner thread: runs 'task' on worker thread (previous job must be waited)
+    void start(std::function<void()> task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if( !worker.joinable() )
+        {
+            worker    = std::thread([this]() { run(); });
+            worker_id = worker.get_id();
+        }
+
+        job  = std::move(task);
+        busy = true;
+        signal.notify_all();
+    }
+
+    // Any thread, except worker one (from 'on_done' - deadlock)
+    void wait() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        signal.wait(lock, [this]() { return !busy; });
+    }
+
+    // As 'wait()', but returns at once on worker thread (its job is done
+    // already, if caller is 'on_done')
+    void wait_unless_worker() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if( std::this_thread::get_id() == worker_id ) {
+            return;
+        }
+        signal.wait(lock, [this]() { return !busy; });
+    }
+
+    bool is_busy() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return busy;
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            signal.notify_all();
+        }
+        if( worker.joinable() ) {
+            worker.join();
+        }
+    }
+
+    // Buffer to fill for next publication (reference passed to caller)
+    LayoutBuffer* take_spare()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        LayoutBuffer* buffer = spare ? spare : new LayoutBuffer{};
+        spare = nullptr;
+        buffer->clear();
+        return buffer;
+    }
+
+    // Takes reference of 'buffer'
+    void publish(LayoutBuffer* buffer)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(current) {
+            retired.push_back(current);
+        }
+        current = buffer;
+        front.store(current);
+    }
+
+    // Any thread: published buffer with new reference (null - none)
+    const LayoutBuffer* acquire() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(current) {
+            current->retain();
+        }
+        return current;
+    }
+
+    // Owner thread, job waited: back to live layouts
+    void drop()
+    {
+        wait();
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(current) {
+            retired.push_back(current);
+            current = nullptr;
+        }
+        front.store(nullptr);
+
+        reclaim_locked();
+    }
+
+    // Owner thread, job waited
+    void reclaim()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        reclaim_locked();
+    }
+
+    void set_result(const taffy_TaffyResult_of_void& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = value;
+    }
+
+    taffy_TaffyResult_of_void get_result() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return result;
+    }
+
+private:
+    // Readers, which loaded retired buffer from 'front', are counted before
+    // the load - so zero count (after buffer replaced in 'front') means no
+    // one uses it. Retired buffer is not acquired anymore, so only its count
+    // of references may decrease.
+    void reclaim_locked()
+    {
+        if( retired.empty() || (readers.load() != 0) ) {
+            return;
+        }
+
+        for(LayoutBuffer* buffer : retired)
+        {
+            if( !spare && (buffer->references.load() == 1) ) {
+                spare = buffer; // not acquired - reused
+                continue;
+            }
+            buffer->release();
+        }
+        retired.clear();
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for(;;)
+        {
+            signal.wait(lock, [this]() { return stopping || static_cast<bool>(job); });
+            if(!job) {
+                return; // stopping
+            }
+
+            std::function<void()> task = std::move(job);
+            job = nullptr;
+
+            lock.unlock();
+            task();
+            lock.lock();
+
+            busy = false;
+            signal.notify_all();
+        }
+    }
+};
+
+/*
+    Rounding of layouts, done by binding instead of taffy: layouts of subtree
+    gathered into contiguous arrays, rounded by SIMD, and written back.
+*/
+struct Rounding
+{
+    bool dirty_only; // round only nodes, laid out by the last computation
+
+    std::vector<uint64_t> dirty; // sorted, recorded before computation
+
+    // Rounded layouts, by node slot. Taffy's own layouts are kept unrounded,
+    // so partial relayouts (and next roundings) start from exact values.
+    struct Rounded
+    {
+        uint64_t      id; // owner node (slots are reused by new nodes)
+        bool          valid;
+        taffy::Layout layout;
+
+        // Rounded from: unrounded layout and absolute position - if both are
+        // the same now, and node is not dirty, its subtree is the same too
+        taffy::Layout source;
+        float         abs_x;
+        float         abs_y;
+    };
+    std::vector<Rounded> layouts;
+
+    struct Frame
+    {
+        taffy::NodeId node;
+        float         abs_x; // of parent, unrounded
+        float         abs_y;
+    };
+
+    // Gathered layouts (scratch)
+    std::vector<taffy::NodeId> nodes;
+    std::vector<float>         x;
+    std::vector<float>         y;
+    std::vector<float>         width;
+    std::vector<float>         height;
+    std::vector<float>         abs_x;
+    std::vector<float>         abs_y;
+
+    std::vector<Frame>         walk; // scratch
+
+    Rounding()
+        : dirty_only(false)
+        , dirty()
+        , layouts()
+        , nodes()
+        , x()
+        , y()
+        , width()
+        , height()
+        , abs_x()
+        , abs_y()
+        , walk()
+    {}
+
+    const taffy::Layout* find(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= layouts.size()) {
+            return nullptr;
+        }
+
+        const Rounded& rounded = layouts[slot];
+        return (rounded.valid && (rounded.id == static_cast<uint64_t>(node))) ? &rounded.layout : nullptr;
+    }
+
+    // Node was rounded from exactly this unrounded layout, at this absolute position
+    bool rounded_from(const taffy::NodeId& node, const taffy::Layout& source, float abs_x, float abs_y) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= layouts.size()) {
+            return false;
+        }
+
+        const Rounded& rounded = layouts[slot];
+        return rounded.valid && (rounded.id == static_cast<uint64_t>(node)) &&
+            (rounded.source.location.x == source.location.x) && (rounded.source.location.y  == source.location.y) &&
+            (rounded.source.size.width == source.size.width) && (rounded.source.size.height == source.size.height) &&
+            (rounded.abs_x == abs_x) && (rounded.abs_y == abs_y);
+    }
+
+    void store(const taffy::NodeId& node, const taffy::Layout& layout, const taffy::Layout& source, float abs_x, float abs_y)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= layouts.size()) {
+            const taffy::Layout empty = taffy::Layout::with_order(0);
+            layouts.resize( slot + 1, Rounded{ 0, false, empty, empty, 0.0f, 0.0f } );
+        }
+
+        Rounded& rounded = layouts[slot];
+        rounded.id     = static_cast<uint64_t>(node);
+        rounded.valid  = true;
+        rounded.layout = layout;
+        rounded.source = source;
+        rounded.abs_x  = abs_x;
+        rounded.abs_y  = abs_y;
+    }
+
+    void erase(const taffy::NodeId& node)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if( (slot < layouts.size()) && (layouts[slot].id == static_cast<uint64_t>(node)) ) {
+            layouts[slot].valid = false;
+        }
+    }
+};
+
+// Report of layouts, changed by computation, and per-node generations
+struct LayoutChanges
+{
+    bool report;      // see 'taffy_Taffy_set_track_layout_changes()'
+    bool generations; // see 'taffy_Taffy_set_track_layout_generations()'
+
+    // Layouts, the last seen by tracking, by node slot - 'previous' ones for
+    // the next report. Unrounded layout and absolute position kept too: with
+    // rounding reported layout of node may stay the same, while its children
+    // are rounded differently.
+    struct Known
+    {
+        uint64_t         id; // owner node (slots are reused by new nodes)
+        bool             valid;
+        taffy_LayoutRect layout;
+        taffy_LayoutRect source;
+        float            abs_x;
+        float            abs_y;
+    };
+    std::vector<Known> known;
+
+    // Known layouts are recorded for all nodes of subtree of 'complete_root',
+    // so next computation of it walks only subtrees, which may be changed
+    bool     complete;
+    uint64_t complete_root;
+
+    // Computation in progress (between 'taffy_c_Taffy_track_begin()' and
+    // 'taffy_c_Taffy_track_end()')
+    bool                  pending;
+    bool                  pending_full; // whole subtree walked
+    uint64_t              pending_root;
+    std::vector<uint64_t> pending_dirty; // sorted, dirty before computation
+
+    std::vector<taffy_LayoutChange> changes; // reported
+
+    // Layout generations, by node slot: 'clock' value of the last computation,
+    // which changed layout of node. Tree-global and monotonic, so generations
+    // are never repeated (also by new nodes in reused slots).
+    struct Stamp
+    {
+        uint64_t id; // owner node (slots are reused by new nodes)
+        uint64_t generation;
+    };
+    std::vector<Stamp> stamps;
+    uint64_t           clock; // the last given generation
+
+    struct Frame
+    {
+        taffy::NodeId node;
+        float         abs_x; // of parent, unrounded
+        float         abs_y;
+    };
+    std::vector<Frame> walk; // scratch
+
+    // Damage rects (scratch)
+    std::unordered_map<uint64_t, size_t> changes_index;
+    std::vector<taffy_LayoutRect>        rects;
+
+    LayoutChanges()
+        : report(false)
+        , generations(false)
+        , known()
+        , complete(false)
+        , complete_root(0)
+        , pending(false)
+        , pending_full(false)
+        , pending_root(0)
+        , pending_dirty()
+        , changes()
+        , stamps()
+        , clock(0)
+        , walk()
+        , changes_index()
+        , rects()
+    {}
+
+    bool enabled() const
+    {
+        return report || generations;
+    }
+
+    const Known* find(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= known.size()) {
+            return nullptr;
+        }
+
+        const Known& k = known[slot];
+        return (k.valid && (k.id == static_cast<uint64_t>(node))) ? &k : nullptr;
+    }
+
+    void remember(const taffy::NodeId& node, const taffy_LayoutRect& layout, const taffy_LayoutRect& source, float abs_x, float abs_y)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= known.size()) {
+            const taffy_LayoutRect empty = { 0.0f, 0.0f, 0.0f, 0.0f };
+            known.resize( slot + 1, Known{ 0, false, empty, empty, 0.0f, 0.0f } );
+        }
+        known[slot] = Known{ static_cast<uint64_t>(node), true, layout, source, abs_x, abs_y };
+    }
+
+    // Known layouts dropped - the next computation walks whole tree
+    void forget()
+    {
+        known.clear();
+        complete = false;
+        pending  = false;
+        pending_dirty.clear();
+    }
+
+    uint64_t generation(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        return ( (slot < stamps.size()) && (stamps[slot].id == static_cast<uint64_t>(node)) ) ? stamps[slot].generation : 0;
+    }
+
+    void stamp(const taffy::NodeId& node, uint64_t generation)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= stamps.size()) {
+            stamps.resize( slot + 1, Stamp{ 0, 0 } );
+        }
+        stamps[slot] = Stamp{ static_cast<uint64_t>(node), generation };
+    }
+
+    void erase(const taffy::NodeId& node)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if( (slot < stamps.size()) && (stamps[slot].id == static_cast<uint64_t>(node)) ) {
+            stamps[slot] = Stamp{ 0, 0 };
+        }
+        if( (slot < known.size()) && (known[slot].id == static_cast<uint64_t>(node)) ) {
+            known[slot].valid = false;
+        }
+    }
+};
+
+// Object behind 'taffy_LayoutSnapshot' pointer. Layouts stored by node slot,
+// in fixed-size chunks: chunks are immutable and shared with the previous
+// snapshot while their layouts are the same, so after small change new
+// snapshot allocates only changed chunks.
+struct LayoutSnapshot
+{
+    static constexpr size_t CHUNK_SIZE = 64; // slots
+
+    struct Entry
+    {
+        uint64_t      id; // owner node (slots are reused by new nodes)
+        bool          valid;
+        taffy::Layout layout;
+    };
+    typedef std::vector<Entry> Chunk; // 'CHUNK_SIZE' entries
+
+    std::atomic<size_t> references;
+
+    uint64_t                                  root;
+    size_t                                    count; // valid entries
+    std::vector< std::shared_ptr<const Chunk> > chunks;
+
+    LayoutSnapshot()
+        : references(1)
+        , root(0)
+        , count(0)
+        , chunks()
+    {}
+
+    const taffy::Layout* find(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= chunks.size() * CHUNK_SIZE) {
+            return nullptr;
+        }
+
+        const Entry& entry = (*chunks[slot / CHUNK_SIZE])[slot % CHUNK_SIZE];
+        return (entry.valid && (entry.id == static_cast<uint64_t>(node))) ? &entry.layout : nullptr;
+    }
+
+    void retain()
+    {
+        references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release()
+    {
+        if(references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+};
+
+// The last snapshot, shared while layouts not changed
+struct Snapshots
+{
+    LayoutSnapshot* current; // owns one reference
+    uint64_t        computations; // 'Taffy::computations' at creation
+    uint64_t        mutations; // 'Relayout::mutations' at creation
+
+    // Scratch: layouts of new snapshot by slot (before split into chunks)
+    std::vector<LayoutSnapshot::Entry> entries;
+    std::vector<taffy::NodeId>         walk;
+
+    Snapshots()
+        : current(nullptr)
+        , computations(0)
+        , mutations(0)
+        , entries()
+        , walk()
+    {}
+
+    ~Snapshots()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        if(current != nullptr)
+        {
+            current->release();
+            current = nullptr;
+        }
+    }
+};
+
+// Index of node in children of its parent, by node slot - siblings found in
+// O(1). Updated by all children mutations (see 'Taffy::reindex_children()'),
+// and checked on use: stale index (node removed from parent) is not trusted.
+struct ChildIndices
+{
+    struct Entry
+    {
+        uint64_t id; // owner node (slots are reused by new nodes)
+        size_t   index;
+    };
+    std::vector<Entry> entries;
+
+    ChildIndices()
+        : entries()
+    {}
+
+    bool find(const taffy::NodeId& node, size_t& index) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if( (slot >= entries.size()) || (entries[slot].id != static_cast<uint64_t>(node)) ) {
+            return false;
+        }
+
+        index = entries[slot].index;
+        return true;
+    }
+
+    void store(const taffy::NodeId& node, size_t index)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= entries.size()) {
+            entries.resize( slot + 1, Entry{ 0, 0 } );
+        }
+        entries[slot] = Entry{ static_cast<uint64_t>(node), index };
+    }
+
+    void erase(const taffy::NodeId& node)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if( (slot < entries.size()) && (entries[slot].id == static_cast<uint64_t>(node)) ) {
+            entries[slot] = Entry{ 0, 0 };
+        }
+    }
+};
+
+// Which nodes have layouts of their current place in the tree, by node slot.
+// Stamps are values of 'Taffy::computations': node is laid out, if layout
+// computation rooted at it (or at its ancestor) ran after it and every node
+// between was attached to its parent (see 'Taffy::is_laid_out()').
+struct LaidOut
+{
+    struct Entry
+    {
+        uint64_t id; // owner node (slots are reused by new nodes)
+        uint64_t attached;
+        uint64_t computed; // computation rooted at node
+    };
+    std::vector<Entry> entries;
+
+    LaidOut()
+        : entries()
+    {}
+
+    const Entry* find(const taffy::NodeId& node) const
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        return ( (slot < entries.size()) && (entries[slot].id == static_cast<uint64_t>(node)) ) ? &entries[slot] : nullptr;
+    }
+
+    void attach(const taffy::NodeId& node, uint64_t stamp)
+    {
+        entry(node).attached = stamp;
+    }
+
+    void compute(const taffy::NodeId& node, uint64_t stamp)
+    {
+        entry(node).computed = stamp;
+    }
+
+    void erase(const taffy::NodeId& node)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if( (slot < entries.size()) && (entries[slot].id == static_cast<uint64_t>(node)) ) {
+            entries[slot] = Entry{ 0, 0, 0 };
+        }
+    }
+
+private:
+    Entry& entry(const taffy::NodeId& node)
+    {
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= entries.size()) {
+            entries.resize( slot + 1, Entry{ 0, 0, 0 } );
+        }
+
+        Entry& e = entries[slot];
+        if( e.id != static_cast<uint64_t>(node) ) {
+            e = Entry{ static_cast<uint64_t>(node), 0, 0 };
+        }
+        return e;
+    }
+};
+
+/*
+    Object behind 'taffy_Taffy' pointer: 'taffy::Taffy' tree + binding-side
+    per-node data.
+
+    Per-node data created on demand (only for nodes, which have something to
+    store) and destroyed together with the node.
+*/
+struct Taffy
+{
+    taffy::Taffy tree;
+
+    // Binding-side node data, indexed by node slot (see 'taffy_NodeId_slot()').
+    // Data allocated separately, since its address captured by measure
+    // functions and must stay stable while 'slots' grows.
+    struct Slot
+    {
+        uint64_t                  id; // owner node (slots are reused by new nodes)
+        std::unique_ptr<NodeData> data;
+    };
+    std::vector<Slot> slots;
+
+    ChildIndices   child_indices;
+    LaidOut        laid_out;
+    MeasureCache   measure_cache;
+    BatchMeasure   batch;
+    ParallelLayout parallel;
+    Relayout       relayout;
+    DirtyNodes     dirty;
+    LayoutStepper  stepper;
+    Snapshots      snapshots;
+    Rounding       rounding_pass;
+    LayoutChanges  layout_changes;
+    AsyncLayout    async; // NOTE: worker stopped by '~Taffy()', before members destroyed
+
+    bool rounding; // NOTE: taffy's own rounding always disabled
+
+    uint64_t computations; // count of layout computations (also of subtrees)
+
+    Taffy()
+        : tree()
+        , slots()
+        , child_indices()
+        , laid_out()
+        , measure_cache()
+        , batch()
+        , parallel()
+        , relayout()
+        , dirty()
+        , stepper()
+        , snapshots()
+        , rounding_pass()
+        , layout_changes()
+        , async()
+        , rounding(true)
+        , computations(0)
+    {
+        tree.disable_rounding(); // rounded by binding (see 'Rounding' section)
+    }
+
+    explicit Taffy(size_t capacity)
+        : tree( taffy::Taffy::with_capacity(capacity) )
+        , slots()
+        , child_indices()
+        , laid_out()
+        , measure_cache()
+        , batch()
+        , parallel()
+        , relayout()
+        , dirty()
+        , stepper()
+        , snapshots()
+        , rounding_pass()
+        , layout_changes()
+        , async()
+        , rounding(true)
+        , computations(0)
+    {
+        tree.disable_rounding(); // rounded by binding (see 'Rounding' section)
+    }
+
+    ~Taffy()
+    {
+        async.stop();
+    }
+
+    const NodeData* find(const taffy::NodeId& node) const
+    {
+        const size_t index = taffy_NodeId_slot(node);
+        if(index >= slots.size()) {
+            return nullptr;
+        }
+
+        const Slot& slot = slots[index];
+        return (slot.id == static_cast<uint64_t>(node)) ? slot.data.get() : nullptr;
+    }
+
+    NodeData* find_mut(const taffy::NodeId& node)
+    {
+        return const_cast<NodeData*>( static_cast<const Taffy*>(this)->find(node) );
+    }
+
+    NodeData& data(const taffy::NodeId& node)
+    {
+        const uint64_t id    = static_cast<uint64_t>(node);
+        const size_t   index = taffy_NodeId_slot(node);
+
+        if(index >= slots.size()) {
+            slots.resize(index + 1);
+        }
+
+        Slot& slot = slots[index];
+        if( (slot.id != id) || (slot.data == nullptr) )
+        {
+            slot.id   = id;
+            slot.data = std::unique_ptr<NodeData>(new NodeData{});
+            slot.data->id = id;
+        }
+        return *slot.data;
+    }
+
+    void* context(const taffy::NodeId& node) const
+    {
+        const NodeData* d = find(node);
+        return (d != nullptr) ? d->context : nullptr;
+    }
+
+    bool contains(const taffy::NodeId& node) const
+    {
+        return tree.style(node).is_ok();
+    }
+
+    // Final layout of node: rounded by binding (if rounding enabled, and node
+    // was rounded already), or taffy's own one. null - if node not exists.
+    const taffy::Layout* layout(const taffy::NodeId& node) const
+    {
+        if(rounding)
+        {
+            const taffy::Layout* rounded = rounding_pass.find(node);
+            if(rounded != nullptr) {
+                return rounded;
+            }
+        }
+
+        const auto result = tree.layout(node);
+        return result.is_ok() ? &result.value().get() : nullptr;
+    }
+
+    taffy::TaffyResult<taffy::NodeId> remove(const taffy::NodeId& node)
+    {
+        // Virtual list spacer is owned by list
+        const NodeData* d = find(node);
+        if( (d != nullptr) && (d->virtual_list != nullptr) ) {
+            remove( taffy::NodeId{d->virtual_list->spacer} );
+        }
+
+        const size_t index = taffy_NodeId_slot(node);
+        if( (index < slots.size()) && (slots[index].id == static_cast<uint64_t>(node)) )
+        {
+            slots[index].id = 0;
+            slots[index].data.reset();
+        }
+        relayout.root_spaces.erase( static_cast<uint64_t>(node) );
+        relayout.unsettle(node);
+        dirty.erase(node);
+        rounding_pass.erase(node);
+        layout_changes.erase(node);
+
+        const auto   parent   = tree.parent(node);
+        const size_t position = child_index(node);
+        child_indices.erase(node);
+        laid_out.erase(node);
+
+        if( parent.is_some() ) {
+            content_changed(parent.value());
+        }
+
+        const auto result = tree.remove(node);
+
+        if( parent.is_some() ) {
+            reindex_children(parent.value(), position);
+        }
+
+        return result;
+    }
+
+    void clear()
+    {
+        slots.clear();
+        child_indices.entries.clear();
+        laid_out.entries.clear();
+        relayout.record_all();
+        relayout.root_spaces.clear();
+        relayout.clear_settled();
+        dirty.clear();
+        rounding_pass.layouts.clear();
+        layout_changes.stamps.clear(); // NOTE: clock not reset - generations not repeated
+        layout_changes.forget();
+
+        tree.clear();
+    }
+
+    // Dirty for taffy, and not settled (see 'Relayout::settled')
+    bool is_dirty(const taffy::NodeId& node) const
+    {
+        const auto result = tree.dirty(node);
+        return result.is_ok() && result.value() && !relayout.is_settled(node);
+    }
+
+    void changed(const taffy::NodeId& node)
+    {
+        relayout.record(node, Relayout::Change::Self);
+        dirty.add(node);
+        unsettle(node);
+    }
+
+    // Index of node in children of its parent (0 - if node has no parent,
+    // or index not known)
+    size_t child_index(const taffy::NodeId& node) const
+    {
+        const auto parent = tree.parent(node);
+        if( !parent.is_some() ) {
+            return 0;
+        }
+
+        size_t index = 0;
+        if( child_indices.find(node, index) )
+        {
+            const auto child = tree.child_at_index(parent.value(), index);
+            if( child.is_ok() && taffy_NodeId_eq(child.value(), node) ) {
+                return index;
+            }
+        }
+
+        // Stale: linear search
+        const auto count = tree.child_count(parent.value());
+        for(size_t i = 0; count.is_ok() && (i < count.value()); ++i)
+        {
+            const auto child = tree.child_at_index(parent.value(), i);
+            if( child.is_ok() && taffy_NodeId_eq(child.value(), node) ) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    // Children of 'parent' from 'first' to the last one got new indices
+    void reindex_children(const taffy::NodeId& parent, size_t first)
+    {
+        const auto count = tree.child_count(parent);
+        if( !count.is_ok() ) {
+            return;
+        }
+
+        for(size_t i = first; i < count.value(); ++i)
+        {
+            const auto child = tree.child_at_index(parent, i);
+            if( child.is_ok() ) {
+                place_child(child.value(), i);
+            }
+        }
+    }
+
+    // Child (new, or moved) got index in its parent. Its layout is not
+    // trusted until laid out again at this place (shifted siblings too -
+    // not told apart).
+    void place_child(const taffy::NodeId& child, size_t index)
+    {
+        child_indices.store(child, index);
+        laid_out.attach(child, computations);
+    }
+
+    // Node has layout of its current place in the tree (see 'LaidOut')
+    bool is_laid_out(const taffy::NodeId& node) const
+    {
+        uint64_t attached = 0;
+
+        taffy::NodeId current = node;
+        for(;;)
+        {
+            const LaidOut::Entry* entry = laid_out.find(current);
+            if(entry != nullptr)
+            {
+                attached = (entry->attached > attached) ? entry->attached : attached;
+                if(entry->computed > attached) {
+                    return true;
+                }
+            }
+
+            const auto parent = tree.parent(current);
+            if( !parent.is_some() ) {
+                return false;
+            }
+            current = parent.value();
+        }
+    }
+
+    void content_changed(const taffy::NodeId& parent)
+    {
+        relayout.record(parent, Relayout::Change::Content);
+        dirty.add(parent);
+        unsettle(parent);
+    }
+
+    // Node and its ancestors are dirty again (as taffy already marked them)
+    void unsettle(const taffy::NodeId& node)
+    {
+        if(relayout.settled_count == 0) {
+            return;
+        }
+
+        relayout.unsettle(node);
+        for(auto parent = tree.parent(node); parent.is_some(); parent = tree.parent(parent.value())) {
+            relayout.unsettle(parent.value());
+        }
+    }
+};
+
+constexpr size_t BatchMeasure::MAX_ROUNDS;
+constexpr size_t Relayout::MAX_CHANGES;
+
+} // namespace taffy_c
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 taffy_Taffy* taffy_Taffy_new_default(void)
 {
-    return reinterpret_cast<taffy_Taffy*>(
-        new taffy::Taffy{}
+    return reinterpret_cast<taffy_Taffy*>(
+        new taffy_c::Taffy{}
+    );
+}
+
+taffy_Taffy* taffy_Taffy_new_with_capacity(size_t capacity)
+{
+    return reinterpret_cast<taffy_Taffy*>(
+        new taffy_c::Taffy{ capacity }
+    );
+}
+
+void taffy_Taffy_delete(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    delete reinterpret_cast<taffy_c::Taffy*>(self);
+    self = nullptr;
+}
+
+// Mutations wait for asynchronous computation (if any) - it uses the tree
+static void taffy_c_Taffy_wait_async(taffy_Taffy* self)
+{
+    reinterpret_cast<const taffy_c::Taffy*>(self)->async.wait();
+}
+
+void taffy_Taffy_enable_rounding(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.rounding = true;
+    tree.rounding_pass.layouts.clear(); // rounded again by next computation
+    tree.relayout.record_all();
+    tree.layout_changes.complete = false; // reported layouts changed - compared again
+}
+
+void taffy_Taffy_disable_rounding(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.rounding = false;
+    tree.rounding_pass.layouts.clear(); // rounded again by next computation
+    tree.relayout.record_all();
+    tree.layout_changes.complete = false; // reported layouts changed - compared again
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_new_leaf(
+    taffy_Taffy* self,
+
+    const taffy_Style* layout
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    ASSERT_NOT_NULL(layout);
+
+    const taffy::Style* _layout = reinterpret_cast<const taffy::Style*>(layout);
+    const auto result = reinterpret_cast<taffy_c::Taffy*>(self)->tree.new_leaf(*_layout);
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+static taffy_AvailableSpace_Type taffy_AvailableSpace_Type_to_c(const taffy::AvailableSpace::Type t)
+{
+    switch(t) {
+    case taffy::AvailableSpace::Type::Definite   : return taffy_AvailableSpace_Type_Definite;
+    case taffy::AvailableSpace::Type::MinContent : return taffy_AvailableSpace_Type_MinContent;
+    case taffy::AvailableSpace::Type::MaxContent : return taffy_AvailableSpace_Type_MaxContent;
+    }
+
+    ASSERT_UNREACHABLE();
+    return taffy_AvailableSpace_Type_MaxContent;
+}
+
+static taffy_MeasureKnownDimensions taffy_MeasureKnownDimensions_from_cpp(const taffy::Size<taffy::Option<float>>& known_dimensions)
+{
+    taffy_MeasureKnownDimensions ret;
+
+    ret.width_is_some  = known_dimensions.width.is_some() ? 1 : 0;
+    ret.width          = known_dimensions.width.is_some() ? known_dimensions.width.value() : 0.0f;
+    ret.height_is_some = known_dimensions.height.is_some() ? 1 : 0;
+    ret.height         = known_dimensions.height.is_some() ? known_dimensions.height.value() : 0.0f;
+
+    return ret;
+}
+
+static taffy_MeasureAvailableSpace taffy_MeasureAvailableSpace_from_cpp(const taffy::Size<taffy::AvailableSpace>& available_space)
+{
+    taffy_MeasureAvailableSpace ret;
+
+    ret.width_type  = taffy_AvailableSpace_Type_to_c(available_space.width.type());
+    ret.width       = (ret.width_type == taffy_AvailableSpace_Type_Definite) ? available_space.width.value() : 0.0f;
+    ret.height_type = taffy_AvailableSpace_Type_to_c(available_space.height.type());
+    ret.height      = (ret.height_type == taffy_AvailableSpace_Type_Definite) ? available_space.height.value() : 0.0f;
+
+    return ret;
+}
+
+static bool taffy_MeasureKnownDimensions_eq(const taffy_MeasureKnownDimensions& lhs, const taffy_MeasureKnownDimensions& rhs)
+{
+    return (lhs.width_is_some  == rhs.width_is_some ) && (!lhs.width_is_some  || (lhs.width  == rhs.width ))
+        && (lhs.height_is_some == rhs.height_is_some) && (!lhs.height_is_some || (lhs.height == rhs.height));
+}
+
+static bool taffy_MeasureAvailableSpace_eq(const taffy_MeasureAvailableSpace& lhs, const taffy_MeasureAvailableSpace& rhs)
+{
+    return (lhs.width_type  == rhs.width_type ) && ((lhs.width_type  != taffy_AvailableSpace_Type_Definite) || (lhs.width  == rhs.width ))
+        && (lhs.height_type == rhs.height_type) && ((lhs.height_type != taffy_AvailableSpace_Type_Definite) || (lhs.height == rhs.height));
+}
+
+static bool taffy_float_near(const float lhs, const float rhs, const float tolerance)
+{
+    const float diff = (lhs > rhs) ? (lhs - rhs) : (rhs - lhs);
+    return diff <= tolerance;
+}
+
+static bool taffy_c_MeasureEntry_matches(
+    const taffy_c::MeasureEntry& entry,
+
+    const taffy_MeasureKnownDimensions& known_dimensions,
+    const taffy_MeasureAvailableSpace&  available_space,
+    const float tolerance
+)
+{
+    const taffy_MeasureKnownDimensions& k = entry.known_dimensions;
+    const taffy_MeasureAvailableSpace&  a = entry.available_space;
+
+    return (k.width_is_some  == known_dimensions.width_is_some ) && (!k.width_is_some  || taffy_float_near(k.width,  known_dimensions.width,  tolerance))
+        && (k.height_is_some == known_dimensions.height_is_some) && (!k.height_is_some || taffy_float_near(k.height, known_dimensions.height, tolerance))
+        && (a.width_type  == available_space.width_type ) && ((a.width_type  != taffy_AvailableSpace_Type_Definite) || taffy_float_near(a.width,  available_space.width,  tolerance))
+        && (a.height_type == available_space.height_type) && ((a.height_type != taffy_AvailableSpace_Type_Definite) || taffy_float_near(a.height, available_space.height, tolerance));
+}
+
+static const taffy_c::MeasureEntry* taffy_c_Taffy_measure_cache_find(
+    taffy_c::Taffy& tree, const taffy_c::NodeData& data,
+
+    const taffy_MeasureKnownDimensions& known_dimensions,
+    const taffy_MeasureAvailableSpace&  available_space
+)
+{
+    for(const taffy_c::MeasureEntry& entry : data.measure_cache)
+    {
+        if( taffy_c_MeasureEntry_matches(entry, known_dimensions, available_space, tree.measure_cache.tolerance) )
+        {
+            tree.measure_cache.hits.fetch_add(1, std::memory_order_relaxed);
+            return &entry;
+        }
+    }
+
+    tree.measure_cache.misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+static void taffy_c_Taffy_measure_cache_store(
+    taffy_c::Taffy& tree, taffy_c::NodeData& data,
+
+    const taffy_c::MeasureEntry& entry
+)
+{
+    const size_t capacity = tree.measure_cache.capacity;
+    if(capacity == 0) {
+        return;
+    }
+
+    if(data.measure_cache.size() < capacity)
+    {
+        data.measure_cache.push_back(entry);
+        return;
+    }
+
+    if(data.measure_cache_next >= capacity) {
+        data.measure_cache_next = 0;
+    }
+    data.measure_cache[data.measure_cache_next] = entry;
+    ++data.measure_cache_next;
+
+    tree.measure_cache.evictions.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void taffy_c_NodeData_measure_cache_clear(taffy_c::NodeData& data)
+{
+    data.measure_cache.clear();
+    data.measure_cache_next = 0;
+}
+
+// Batch mode measure: returns known result, or records request and returns
+// provisional result (known dimensions, or zero)
+static taffy_MeasureSize taffy_c_Taffy_batch_measure(
+    taffy_c::Taffy& tree, taffy_c::NodeData& data,
+
+    const taffy_MeasureKnownDimensions& known_dimensions,
+    const taffy_MeasureAvailableSpace&  available_space
+)
+{
+    taffy_c::BatchMeasure& batch = tree.batch;
+
+    for(size_t i = 0; i < data.batch_results.size(); ++i)
+    {
+        const taffy_c::MeasureEntry& entry = data.batch_results[i];
+        if( taffy_MeasureKnownDimensions_eq(entry.known_dimensions, known_dimensions) && taffy_MeasureAvailableSpace_eq(entry.available_space, available_space) ) {
+            return entry.size; // resolved, or provisional (if still pending)
+        }
+    }
+
+    taffy_MeasureRequest request;
+    request.node.id          = data.id;
+    request.user_data        = data.measure_user_data;
+    request.known_dimensions = known_dimensions;
+    request.available_space  = available_space;
+
+    taffy_c::MeasureEntry entry;
+    entry.known_dimensions = known_dimensions;
+    entry.available_space  = available_space;
+    entry.size.width       = known_dimensions.width_is_some  ? known_dimensions.width  : 0.0f;
+    entry.size.height      = known_dimensions.height_is_some ? known_dimensions.height : 0.0f;
+
+    if(data.batch_results.empty()) {
+        batch.measured.push_back(&data);
+    }
+
+    if(batch.synchronous)
+    {
+        batch.func(&request, 1, &entry.size, batch.user_data);
+
+        data.batch_results.push_back(entry);
+        taffy_c_Taffy_measure_cache_store(tree, data, entry);
+        return entry.size;
+    }
+
+    data.batch_results.push_back(entry);
+    ++data.batch_pending;
+
+    batch.requests.push_back(request);
+    batch.requesters.push_back(&data);
+
+    return entry.size;
+}
+
+static void taffy_c_FixedText_assign(taffy_c::FixedText& self, const taffy_FixedText& text)
+{
+    self.glyph_count = text.glyph_count;
+    self.advance     = (text.advance     > 0.0f) ? text.advance     : 0.0f;
+    self.line_height = (text.line_height > 0.0f) ? text.line_height : 0.0f;
+    self.wrap        = text.wrap;
+
+    self.breaks.clear();
+    if(text.wrap == taffy_FixedText_Wrap_Word)
+    {
+        for(size_t i = 0; i < text.break_offsets_count; ++i)
+        {
+            const size_t offset = text.break_offsets[i];
+            if( (offset > 0) && (offset < text.glyph_count) ) {
+                self.breaks.push_back(offset);
+            }
+        }
+        std::sort(self.breaks.begin(), self.breaks.end());
+        self.breaks.erase( std::unique(self.breaks.begin(), self.breaks.end()), self.breaks.end() );
+    }
+
+    self.max_word = 0;
+    size_t start = 0;
+    for(const size_t offset : self.breaks)
+    {
+        self.max_word = std::max(self.max_word, offset - start);
+        start = offset;
+    }
+    self.max_word = std::max(self.max_word, self.glyph_count - start);
+}
+
+// Count of glyphs, fitting into width
+static size_t taffy_c_FixedText_glyphs_fit(const taffy_c::FixedText& self, const float width)
+{
+    if( (self.advance <= 0.0f) || (width >= static_cast<float>(self.glyph_count) * self.advance) ) {
+        return self.glyph_count;
+    }
+    if(width <= 0.0f) {
+        return 0;
+    }
+
+    // NOTE: small epsilon, so width, computed as 'n * advance' fits exactly n glyphs
+    return static_cast<size_t>( (width / self.advance) + 1e-4f );
+}
+
+// Greedy line breaking, with at most 'limit' glyphs per line (longer words
+// overflow). Each line start is found by binary search over break offsets,
+// so cost is O(lines * log(breaks)), not O(glyphs).
+static void taffy_c_FixedText_break_lines(const taffy_c::FixedText& self, const size_t limit, size_t& lines, size_t& longest)
+{
+    lines   = 0;
+    longest = 0;
+
+    const size_t count = self.glyph_count;
+    if(count == 0) {
+        return;
+    }
+
+    if( (self.wrap == taffy_FixedText_Wrap_None) || (limit >= count) )
+    {
+        lines   = 1;
+        longest = count;
+        return;
+    }
+
+    const size_t per_line = (limit > 0) ? limit : 1;
+
+    if(self.wrap == taffy_FixedText_Wrap_Glyph)
+    {
+        lines   = (count + per_line - 1) / per_line;
+        longest = per_line;
+        return;
+    }
+
+    if(limit == 0) // min-content: each word on its own line
+    {
+        lines   = self.breaks.size() + 1;
+        longest = self.max_word;
+        return;
+    }
+
+    const auto begin = self.breaks.begin();
+    const auto end   = self.breaks.end();
+
+    size_t start = 0;
+    while(start < count)
+    {
+        size_t next;
+        if(count - start <= per_line)
+        {
+            next = count;
+        }
+        else
+        {
+            auto it = std::upper_bound(begin, end, start + per_line); // first break, not fitting
+            if( (it != begin) && (*(it - 1) > start) ) {
+                next = *(it - 1);
+            } else {
+                it = std::upper_bound(begin, end, start); // overflowing word: up to next break
+                next = (it != end) ? *it : count;
+            }
+        }
+
+        ++lines;
+        longest = std::max(longest, next - start);
+        start   = next;
+    }
+}
+
+static taffy::Size<float> taffy_c_FixedText_measure(
+    const taffy_c::FixedText& self,
+
+    const taffy::Size<taffy::Option<float>>& known_dimensions,
+    const taffy::Size<taffy::AvailableSpace>& available_space
+)
+{
+    size_t limit = self.glyph_count;
+    if( known_dimensions.width.is_some() ) {
+        limit = taffy_c_FixedText_glyphs_fit(self, known_dimensions.width.value());
+    } else {
+        switch( available_space.width.type() )
+        {
+        case taffy::AvailableSpace::Type::Definite:   { limit = taffy_c_FixedText_glyphs_fit(self, available_space.width.value()); } break;
+        case taffy::AvailableSpace::Type::MinContent: { limit = 0;                                                                  } break;
+        case taffy::AvailableSpace::Type::MaxContent: { limit = self.glyph_count;                                                   } break;
+        }
+    }
+
+    size_t lines   = 0;
+    size_t longest = 0;
+    taffy_c_FixedText_break_lines(self, limit, lines, longest);
+
+    return taffy::Size<float>{
+        known_dimensions.width.is_some()  ? known_dimensions.width.value()  : static_cast<float>(longest) * self.advance,
+        known_dimensions.height.is_some() ? known_dimensions.height.value() : static_cast<float>(lines)   * self.line_height
+    };
+}
+
+// Called by taffy during layout. Known dimensions are returned as-is, without
+// calling user function (the same as taffy does for its own leaves).
+static taffy::Size<float> taffy_c_NodeData_measure(
+    taffy_c::Taffy& tree, taffy_c::NodeData& data,
+
+    const taffy::Size<taffy::Option<float>>& known_dimensions,
+    const taffy::Size<taffy::AvailableSpace>& available_space
+)
+{
+    if( known_dimensions.width.is_some() && known_dimensions.height.is_some() ) {
+        return taffy::Size<float>{ known_dimensions.width.value(), known_dimensions.height.value() };
+    }
+
+    if(data.fixed_text) { // cheap enough, not cached
+        return taffy_c_FixedText_measure(*data.fixed_text, known_dimensions, available_space);
+    }
+
+    const taffy_MeasureKnownDimensions _known_dimensions = taffy_MeasureKnownDimensions_from_cpp(known_dimensions);
+    const taffy_MeasureAvailableSpace  _available_space  = taffy_MeasureAvailableSpace_from_cpp(available_space);
+
+    if(tree.measure_cache.capacity > 0)
+    {
+        const taffy_c::MeasureEntry* cached = taffy_c_Taffy_measure_cache_find(tree, data, _known_dimensions, _available_space);
+        if(cached != nullptr) {
+            return taffy::Size<float>{ cached->size.width, cached->size.height };
+        }
+    }
+
+    if(tree.batch.func != nullptr)
+    {
+        const taffy_MeasureSize size = taffy_c_Taffy_batch_measure(tree, data, _known_dimensions, _available_space);
+        return taffy::Size<float>{ size.width, size.height };
+    }
+
+    taffy_c::MeasureEntry entry;
+    entry.known_dimensions = _known_dimensions;
+    entry.available_space  = _available_space;
+    entry.size             = data.measure(_known_dimensions, _available_space, data.measure_user_data);
+
+    taffy_c_Taffy_measure_cache_store(tree, data, entry);
+
+    return taffy::Size<float>{ entry.size.width, entry.size.height };
+}
+
+// Functor captures only pointers to tree and per-node data (which address is
+// stable - each 'NodeData' allocated separately from slots), so it fits into
+// small-object storage of function wrapper and measure calls do not allocate.
+static taffy::MeasureFunc taffy_c_NodeData_make_measure_func(taffy_c::Taffy* tree, taffy_c::NodeData* data)
+{
+    return taffy::MeasureFunc{
+        [tree, data](const taffy::Size<taffy::Option<float>>& known_dimensions, const taffy::Size<taffy::AvailableSpace>& available_space) -> taffy::Size<float>
+        {
+            return taffy_c_NodeData_measure(*tree, *data, known_dimensions, available_space);
+        }
+    };
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_new_leaf_with_measure(
+    taffy_Taffy* self,
+
+    const taffy_Style* layout,
+    taffy_MeasureFunc measure, void* user_data
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    ASSERT_NOT_NULL(layout);
+    ASSERT_NOT_NULL(measure);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    // NOTE: node created as plain leaf firstly, since measure functor needs
+    // per-node data address, keyed by node id
+    const taffy::Style* _layout = reinterpret_cast<const taffy::Style*>(layout);
+    const auto result = tree.tree.new_leaf(*_layout);
+    if( !result.is_ok() ) {
+        return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    }
+
+    taffy_c::NodeData& data = tree.data(result.value());
+    data.measure           = measure;
+    data.measure_user_data = user_data;
+
+    tree.tree.set_measure(result.value(), taffy::Option<taffy::MeasureFunc>{ taffy_c_NodeData_make_measure_func(&tree, &data) });
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_new_leaf_with_fixed_text(
+    taffy_Taffy* self,
+
+    const taffy_Style* layout,
+    const taffy_FixedText* text
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    ASSERT_NOT_NULL(layout);
+    ASSERT_NOT_NULL(text);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const taffy::Style* _layout = reinterpret_cast<const taffy::Style*>(layout);
+    const auto result = tree.tree.new_leaf(*_layout);
+    if( !result.is_ok() ) {
+        return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    }
+
+    taffy_c::NodeData& data = tree.data(result.value());
+    data.fixed_text.reset(new taffy_c::FixedText{});
+    taffy_c_FixedText_assign(*data.fixed_text, *text);
+
+    tree.tree.set_measure(result.value(), taffy::Option<taffy::MeasureFunc>{ taffy_c_NodeData_make_measure_func(&tree, &data) });
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_new_with_children(
+    taffy_Taffy* self,
+
+    const taffy_Style* layout,
+    const taffy_NodeId* childs, size_t childs_count
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    ASSERT_NOT_NULL(layout);
+    if(childs_count > 0)
+    {
+        ASSERT_NOT_NULL(childs);
+    }
+
+    const taffy::Style* _layout = reinterpret_cast<const taffy::Style*>(layout);
+    const taffy::NodeId* _childs = reinterpret_cast<const taffy::NodeId*>(childs);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.new_with_children(
+        *_layout,
+        taffy::Vec<taffy::NodeId>{_childs, _childs + childs_count} // NOTE: Entire vector copy here :/
+    );
+
+    if( result.is_ok() ) {
+        tree.reindex_children(result.value(), 0);
+    }
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+void taffy_Taffy_clear(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    reinterpret_cast<taffy_c::Taffy*>(self)->clear();
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_remove(
+    taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    const auto result = reinterpret_cast<taffy_c::Taffy*>(self)->remove(
+        taffy::NodeId{node.id}
+    );
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_set_measure(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, taffy_MeasureFunc measure, void* user_data
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const taffy::NodeId _node { node.id };
+
+    if(measure == nullptr)
+    {
+        const auto result = tree.tree.set_measure(_node, taffy::Option<taffy::MeasureFunc>{});
+        if( result.is_ok() ) {
+            tree.changed(_node);
+        }
+
+        taffy_c::NodeData* data = tree.find_mut(_node);
+        if(data != nullptr)
+        {
+            data->measure           = nullptr;
+            data->measure_user_data = nullptr;
+            data->fixed_text.reset();
+
+            taffy_c_NodeData_measure_cache_clear(*data);
+        }
+
+        return taffy_TaffyResult_of_void_from_cpp(result);
+    }
+
+    if( !tree.contains(_node) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    taffy_c::NodeData& data = tree.data(_node);
+    data.measure           = measure;
+    data.measure_user_data = user_data;
+    data.fixed_text.reset();
+
+    taffy_c_NodeData_measure_cache_clear(data);
+
+    const auto result = tree.tree.set_measure(_node, taffy::Option<taffy::MeasureFunc>{ taffy_c_NodeData_make_measure_func(&tree, &data) });
+    if( result.is_ok() ) {
+        tree.changed(_node);
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+void* taffy_Taffy_get_measure_user_data(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::NodeData* data = reinterpret_cast<const taffy_c::Taffy*>(self)->find( taffy::NodeId{node.id} );
+    return ( (data != nullptr) && (data->measure != nullptr) ) ? data->measure_user_data : nullptr;
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_set_fixed_text(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, const taffy_FixedText* text
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    ASSERT_NOT_NULL(text);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const taffy::NodeId _node { node.id };
+
+    if( !tree.contains(_node) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    taffy_c::NodeData& data = tree.data(_node);
+    data.measure           = nullptr;
+    data.measure_user_data = nullptr;
+    if( !data.fixed_text ) {
+        data.fixed_text.reset(new taffy_c::FixedText{});
+    }
+    taffy_c_FixedText_assign(*data.fixed_text, *text);
+
+    taffy_c_NodeData_measure_cache_clear(data);
+
+    // NOTE: measure functor set again, since it also marks node dirty
+    const auto result = tree.tree.set_measure(_node, taffy::Option<taffy::MeasureFunc>{ taffy_c_NodeData_make_measure_func(&tree, &data) });
+    if( result.is_ok() ) {
+        tree.changed(_node);
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+void taffy_Taffy_set_batch_measure(
+    taffy_Taffy* self,
+
+    taffy_BatchMeasureFunc measure, void* user_data
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::BatchMeasure& batch = reinterpret_cast<taffy_c::Taffy*>(self)->batch;
+    batch.func      = measure;
+    batch.user_data = (measure != nullptr) ? user_data : nullptr;
+}
+
+void taffy_Taffy_set_measure_cache(
+    taffy_Taffy* self,
+
+    size_t entries_per_node, float tolerance
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    tree.measure_cache.capacity  = entries_per_node;
+    tree.measure_cache.tolerance = (tolerance > 0.0f) ? tolerance : 0.0f;
+
+    for(auto& slot : tree.slots) {
+        if(slot.data != nullptr) {
+            taffy_c_NodeData_measure_cache_clear(*slot.data);
+        }
+    }
+}
+
+taffy_MeasureCacheStats taffy_Taffy_measure_cache_stats(const taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::MeasureCache& cache = reinterpret_cast<const taffy_c::Taffy*>(self)->measure_cache;
+
+    taffy_MeasureCacheStats stats;
+    stats.hits      = cache.hits     .load(std::memory_order_relaxed);
+    stats.misses    = cache.misses   .load(std::memory_order_relaxed);
+    stats.evictions = cache.evictions.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void taffy_Taffy_reset_measure_cache_stats(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    taffy_c::MeasureCache& cache = reinterpret_cast<taffy_c::Taffy*>(self)->measure_cache;
+    cache.hits     .store(0, std::memory_order_relaxed);
+    cache.misses   .store(0, std::memory_order_relaxed);
+    cache.evictions.store(0, std::memory_order_relaxed);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_invalidate_measure(
+    taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const taffy::NodeId _node { node.id };
+
+    taffy_c::NodeData* data = tree.find_mut(_node);
+    if(data != nullptr) {
+        taffy_c_NodeData_measure_cache_clear(*data);
+    }
+
+    // Taffy own cache holds results of previous measure too
+    const auto result = tree.tree.mark_dirty(_node);
+    if( result.is_ok() ) {
+        tree.changed(_node);
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_add_child(
+    taffy_Taffy* self,
+
+    taffy_NodeId parent, taffy_NodeId child
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.add_child(
+        taffy::NodeId{parent.id}, taffy::NodeId{child.id}
+    );
+
+    if( result.is_ok() ) {
+        tree.content_changed( taffy::NodeId{parent.id} );
+        tree.place_child( taffy::NodeId{child.id}, tree.tree.child_count( taffy::NodeId{parent.id} ).value() - 1 );
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_insert_child_at_index(
+    taffy_Taffy* self,
+
+    taffy_NodeId parent, size_t child_index, taffy_NodeId child
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.insert_child_at_index(
+        taffy::NodeId{parent.id}, child_index, taffy::NodeId{child.id}
+    );
+
+    if( result.is_ok() ) {
+        tree.content_changed( taffy::NodeId{parent.id} );
+        tree.reindex_children( taffy::NodeId{parent.id}, child_index ); // following ones shifted
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_set_children(
+    taffy_Taffy* self,
+
+    taffy_NodeId parent, const taffy_NodeId* childs, size_t childs_count
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    if(childs_count > 0) {
+        ASSERT_NOT_NULL(childs);
+    }
+
+    const taffy::NodeId* _childs = reinterpret_cast<const taffy::NodeId*>(childs);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.set_children(
+        taffy::NodeId{parent.id},
+        taffy::Vec<taffy::NodeId>{_childs, _childs + childs_count} // NOTE: Entire vector copy here :/
+    );
+
+    if( result.is_ok() ) {
+        tree.content_changed( taffy::NodeId{parent.id} );
+        tree.reindex_children( taffy::NodeId{parent.id}, 0 );
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_remove_child(
+    taffy_Taffy* self,
+
+    taffy_NodeId parent, taffy_NodeId child
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const size_t position = tree.child_index( taffy::NodeId{child.id} );
+
+    const auto result = tree.tree.remove_child(
+        taffy::NodeId{parent.id}, taffy::NodeId{child.id}
+    );
+
+    if( result.is_ok() ) {
+        tree.content_changed( taffy::NodeId{parent.id} );
+        tree.child_indices.erase( taffy::NodeId{child.id} );
+        tree.reindex_children( taffy::NodeId{parent.id}, position ); // following ones shifted
+    }
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_remove_child_at_index(
+    taffy_Taffy* self,
+
+    taffy_NodeId parent, size_t child_index
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.remove_child_at_index(
+        taffy::NodeId{parent.id}, child_index
+    );
+
+    if( result.is_ok() ) {
+        tree.content_changed( taffy::NodeId{parent.id} );
+        tree.child_indices.erase(result.value());
+        tree.reindex_children( taffy::NodeId{parent.id}, child_index ); // following ones shifted
+    }
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_NodeId replace_child_at_index(
+    taffy_Taffy* self,
+
+    taffy_NodeId parent, size_t child_index, taffy_NodeId child
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.replace_child_at_index(
+        taffy::NodeId{parent.id}, child_index, taffy::NodeId{child.id}
+    );
+
+    if( result.is_ok() ) {
+        tree.content_changed( taffy::NodeId{parent.id} );
+        tree.child_indices.erase(result.value());
+        tree.place_child( taffy::NodeId{child.id}, child_index );
+    }
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_NodeId taffy_Taffy_child_at_index(
+    const taffy_Taffy* self,
+
+    taffy_NodeId parent, size_t child_index
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const auto result = reinterpret_cast<const taffy_c::Taffy*>(self)->tree.child_at_index(
+        taffy::NodeId{parent.id}, child_index
+    );
+
+    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_size_t taffy_Taffy_child_count(
+    const taffy_Taffy* self,
+
+    taffy_NodeId parent
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const auto result = reinterpret_cast<const taffy_c::Taffy*>(self)->tree.child_count(
+        taffy::NodeId{parent.id}
+    );
+
+    return taffy_TaffyResult_of_size_t_from_cpp(result);
+}
+
+taffy_TaffyResult_of_Vec_of_NodeId taffy_Taffy_children(
+    const taffy_Taffy* self,
+
+    taffy_NodeId parent
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const auto result = reinterpret_cast<const taffy_c::Taffy*>(self)->tree.Children(
+        taffy::NodeId{parent.id}
+    );
+
+    return taffy_TaffyResult_of_Vec_of_NodeId_from_cpp(result);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_set_style(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, const taffy_Style* style
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    ASSERT_NOT_NULL(style);
+
+    const taffy::Style* _style = reinterpret_cast<const taffy::Style*>(style);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.set_style(
+        taffy::NodeId{node.id}, *_style
+    );
+
+    if( result.is_ok() ) {
+        tree.changed( taffy::NodeId{node.id} );
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+taffy_TaffyResult_of_Style_const_ref taffy_Taffy_style(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const auto result = reinterpret_cast<const taffy_c::Taffy*>(self)->tree.style(
+        taffy::NodeId{node.id}
+    );
+
+    return taffy_TaffyResult_of_Style_const_ref_from_cpp(result);
+}
+
+// Final layout (see 'taffy_c::Taffy::layout()') as result
+static taffy_TaffyResult_of_Layout_const_ref taffy_c_Taffy_layout_result(const taffy_c::Taffy& tree, const taffy::NodeId& node)
+{
+    taffy_TaffyResult_of_Layout_const_ref ret;
+    ret.error.child_index = 0;
+    ret.error.child_count = 0;
+
+    const taffy::Layout* layout = tree.layout(node);
+    if(layout == nullptr)
+    {
+        ret.error.type    = taffy_TaffyError_Type_InvalidInputNode;
+        ret.error.node.id = static_cast<uint64_t>(node);
+        ret.value         = nullptr;
+        return ret;
+    }
+
+    ret.error.type    = taffy_TaffyError_Type_Ok;
+    ret.error.node.id = 0;
+    ret.value         = reinterpret_cast<const taffy_Layout*>(layout);
+    return ret;
+}
+
+taffy_TaffyResult_of_Layout_const_ref taffy_Taffy_layout(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+
+    const taffy_c::AsyncLayout& async = tree.async;
+
+    // Published layouts (see 'AsyncLayout')
+    async.readers.fetch_add(1);
+    const taffy_c::LayoutBuffer* front = async.front.load();
+    const taffy::Layout* published = (front != nullptr) ? front->find( taffy::NodeId{node.id} ) : nullptr;
+    async.readers.fetch_sub(1);
+
+    if(published != nullptr)
+    {
+        taffy_TaffyResult_of_Layout_const_ref ret;
+        ret.error.type        = taffy_TaffyError_Type_Ok;
+        ret.error.node.id     = 0;
+        ret.error.child_index = 0;
+        ret.error.child_count = 0;
+        ret.value = reinterpret_cast<const taffy_Layout*>(published);
+        return ret;
+    }
+
+    // Not published (outside of computed subtree, or created after
+    // publication) - live layout, after computation
+    if(front != nullptr) {
+        async.wait_unless_worker();
+    }
+
+    return taffy_c_Taffy_layout_result( tree, taffy::NodeId{node.id} );
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_mark_dirty(
+    taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.mark_dirty(
+        taffy::NodeId{node.id}
+    );
+
+    if( result.is_ok() ) {
+        tree.changed( taffy::NodeId{node.id} );
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+taffy_TaffyResult_of_bool taffy_Taffy_dirty(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+
+    const auto result = tree.tree.dirty(
+        taffy::NodeId{node.id}
+    );
+
+    taffy_TaffyResult_of_bool ret = taffy_TaffyResult_of_bool_from_cpp(result);
+    if( result.is_ok() && tree.relayout.is_settled( taffy::NodeId{node.id} ) ) {
+        ret.value = 0; /* false */
+    }
+    return ret;
+}
+
+static taffy::TaffyResult<void> taffy_c_Taffy_compute_layout_batched(taffy_c::Taffy& tree, const taffy::NodeId& node, const taffy::Size<taffy::AvailableSpace>& available_space)
+{
+    taffy_c::BatchMeasure& batch = tree.batch;
+
+    batch.synchronous = false;
+
+    for(size_t round = 0; ; ++round)
+    {
+        batch.requests.clear();
+        batch.requesters.clear();
+
+        if(round == taffy_c::BatchMeasure::MAX_ROUNDS) {
+            batch.synchronous = true;
+        }
+
+        const auto result = tree.tree.compute_layout(node, available_space);
+        if( !result.is_ok() || batch.requests.empty() ) {
+            return result;
+        }
+
+        // Measure all collected requests by single call
+        batch.results.resize(batch.requests.size());
+        batch.func(batch.requests.data(), batch.requests.size(), batch.results.data(), batch.user_data);
+
+        for(size_t i = 0; i < batch.requests.size(); ++i)
+        {
+            taffy_c::NodeData& data = *batch.requesters[i];
+
+            // Pending entries are at the end, in requests order
+            taffy_c::MeasureEntry& entry = data.batch_results[ data.batch_results.size() - data.batch_pending ];
+            entry.size = batch.results[i];
+            --data.batch_pending;
+
+            taffy_c_Taffy_measure_cache_store(tree, data, entry);
+        }
+
+        // Provisional results are in taffy cache - drop it for affected leaves
+        for(size_t i = 0; i < batch.requesters.size(); ++i) {
+            tree.tree.mark_dirty( taffy::NodeId{ batch.requesters[i]->id } );
+        }
+    }
+}
+
+// Defined in 'Parallel layout' section
+static void taffy_c_Taffy_precompute_subtrees(taffy_c::Taffy& tree, const taffy::NodeId& root);
+
+// Defined in 'Rounding' section
+static void taffy_c_Taffy_record_dirty(taffy_c::Taffy& tree, const taffy::NodeId& root);
+static void taffy_c_Taffy_round_layouts(taffy_c::Taffy& tree, const taffy::NodeId& root);
+
+static taffy::TaffyResult<void> taffy_c_Taffy_compute_unrounded(taffy_c::Taffy& tree, const taffy::NodeId& node, const taffy::Size<taffy::AvailableSpace>& available_space)
+{
+    if(tree.batch.func == nullptr)
+    {
+        if(tree.parallel.pool != nullptr) {
+            taffy_c_Taffy_precompute_subtrees(tree, node);
+        }
+
+        return tree.tree.compute_layout(node, available_space);
+    }
+
+    const auto result = taffy_c_Taffy_compute_layout_batched(tree, node, available_space);
+
+    for(taffy_c::NodeData* data : tree.batch.measured)
+    {
+        data->batch_results.clear();
+        data->batch_pending = 0;
+    }
+    tree.batch.measured.clear();
+    tree.batch.synchronous = false;
+
+    return result;
+}
+
+// Drops laid out (clean or settled) nodes from dirty nodes list
+static void taffy_c_Taffy_prune_dirty_nodes(taffy_c::Taffy& tree)
+{
+    if( tree.dirty.list.empty() ) {
+        return;
+    }
+
+    const taffy_c::Taffy& t = tree;
+    tree.dirty.retain( [&t](const taffy::NodeId& dirty_node) { return t.is_dirty(dirty_node); } );
+}
+
+/*
+    Layout of 'node' as root (of the whole tree, or in place - of inner node).
+
+    'in_place' - node's layout before computation, for inner node: taffy lays
+    root out at zero position, so its own position (and order) restored before
+    rounding. Its size is the new one.
+*/
+static taffy::TaffyResult<void> taffy_c_Taffy_compute_root(taffy_c::Taffy& tree, const taffy::NodeId& node, const taffy::Size<taffy::AvailableSpace>& available_space, const taffy::Layout* in_place = nullptr)
+{
+    ++tree.computations;
+
+    const bool round = tree.rounding;
+    if(round && tree.rounding_pass.dirty_only) {
+        taffy_c_Taffy_record_dirty(tree, node);
+    }
+
+    const auto result = taffy_c_Taffy_compute_unrounded(tree, node, available_space);
+
+    if( result.is_ok() ) {
+        tree.laid_out.compute(node, tree.computations);
+    }
+
+    if( (in_place != nullptr) && result.is_ok() )
+    {
+        // NOTE: 'taffy::Taffy' has no mutable access to layouts, but its
+        // storage itself is not const
+        taffy::Layout& layout = const_cast<taffy::Layout&>( tree.tree.layout(node).value().get() );
+
+        const taffy::Size<float> size = layout.size;
+        layout      = *in_place;
+        layout.size = size;
+    }
+
+    if(round && result.is_ok()) {
+        taffy_c_Taffy_round_layouts(tree, node);
+    }
+
+    // Laid out nodes are clean now
+    taffy_c_Taffy_prune_dirty_nodes(tree);
+
+    return result;
+}
+
+// Size of node with such style not depends on its parent, nor on its content
+static bool taffy_c_Style_is_fixed_size(const taffy::Style& style)
+{
+    const auto fixed = [](const taffy::Dimension& d) {
+        return d.type() == taffy::Dimension::Type::Length;
+    };
+    const auto fixed_or_auto = [](const taffy::Dimension& d) {
+        return (d.type() == taffy::Dimension::Type::Length) || (d.type() == taffy::Dimension::Type::Auto);
+    };
+    const auto length = [](const taffy::LengthPercentage& lp) {
+        return lp.type() == taffy::LengthPercentage::Type::Length;
+    };
+
+    return (style.display.type() != taffy::Display::Type::None) &&
+        fixed(style.size.width) && fixed(style.size.height) &&
+        fixed_or_auto(style.min_size.width) && fixed_or_auto(style.min_size.height) &&
+        fixed_or_auto(style.max_size.width) && fixed_or_auto(style.max_size.height) &&
+        // not flexed by parent
+        (style.flex_grow == 0.0f) && (style.flex_shrink == 0.0f) &&
+        (style.flex_basis.type() == taffy::Dimension::Type::Auto) &&
+        // percentages resolved against parent size - content of node depends on them
+        length(style.padding.left) && length(style.padding.right) && length(style.padding.top) && length(style.padding.bottom) &&
+        length(style.border .left) && length(style.border .right) && length(style.border .top) && length(style.border .bottom);
+}
+
+/*
+    Lays out subtree of laid out inner 'node' again, in place: as root, in
+    available space of its previous (unrounded) size, keeping its position.
+    Rounded at its absolute position. Returns 'false' on failure (or if node
+    not laid out yet at its place).
+
+    'keep_size' - node's size must stay the same (relayout boundary): result
+    is rejected (caller must lay out the whole tree), if subtree came out at
+    other size - node, which style not fixes its size (explicitly flagged),
+    sized by its content as root. Style is not touched: it would dirty
+    ancestors and clear node's cache. Otherwise new size may differ from
+    previous one (then caller must lay out the whole tree).
+*/
+static bool taffy_c_Taffy_compute_in_place(taffy_c::Taffy& tree, const taffy::NodeId& node, bool keep_size)
+{
+    const auto layout = tree.tree.layout(node);
+    if( !layout.is_ok() || !tree.is_laid_out(node) ) {
+        return false;
+    }
+    const taffy::Layout previous = layout.value().get();
+
+    const taffy::Size<taffy::AvailableSpace> available_space {
+        taffy::AvailableSpace::Definite(previous.size.width),
+        taffy::AvailableSpace::Definite(previous.size.height)
+    };
+
+    if( !taffy_c_Taffy_compute_root(tree, node, available_space, &previous).is_ok() ) {
+        return false;
+    }
+
+    const taffy::Size<float>& size = tree.tree.layout(node).value().get().size;
+    return !keep_size || ( (size.width == previous.size.width) && (size.height == previous.size.height) );
+}
+
+// Marks node and its ancestors settled (see 'Relayout::settled'), after its
+// in place layout
+static void taffy_c_Taffy_settle(taffy_c::Taffy& tree, const taffy::NodeId& node)
+{
+    tree.relayout.settle(node);
+    for(auto parent = tree.tree.parent(node); parent.is_some(); parent = tree.tree.parent(parent.value())) {
+        tree.relayout.settle(parent.value());
+    }
+}
+
+static bool taffy_c_Taffy_is_relayout_boundary(const taffy_c::Taffy& tree, const taffy::NodeId& node)
+{
+    const taffy_c::NodeData* data = tree.find(node);
+    if( (data != nullptr) && data->relayout_boundary ) {
+        return true;
+    }
+
+    const auto style = tree.tree.style(node);
+    return style.is_ok() && taffy_c_Style_is_fixed_size(style.value().get());
+}
+
+/*
+    Lays out again only subtrees of relayout boundaries, containing recorded
+    changes. Returns 'false' if it is not possible (some change is not inside
+    of any boundary) - then whole tree must be laid out.
+*/
+static bool taffy_c_Taffy_relayout_boundaries(taffy_c::Taffy& tree, const taffy::NodeId& root)
+{
+    taffy_c::Relayout& relayout = tree.relayout;
+
+    std::vector<uint64_t>& boundaries = relayout.boundaries;
+    boundaries.clear();
+
+    // 1. Nearest boundary for each change. If node itself changed, its own
+    //    size may change too - so boundary searched from its parent.
+    for(const taffy_c::Relayout::Record& record : relayout.changes)
+    {
+        taffy::NodeId node = record.node;
+        if(record.change == taffy_c::Relayout::Change::Self)
+        {
+            const auto parent = tree.tree.parent(node);
+            if( parent.is_none() ) {
+                return false;
+            }
+            node = parent.value();
+        }
+
+        bool     found    = false;
+        uint64_t boundary = 0;
+        while(node != root) // NOTE: root itself always laid out entirely
+        {
+            if( !found && taffy_c_Taffy_is_relayout_boundary(tree, node) )
+            {
+                found    = true;
+                boundary = static_cast<uint64_t>(node);
+            }
+
+            const auto parent = tree.tree.parent(node);
+            if( parent.is_none() ) {
+                return false; // not in the tree of 'root' (or removed)
+            }
+            node = parent.value();
+        }
+
+        if(!found) {
+            return false;
+        }
+        boundaries.push_back(boundary);
+    }
+
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase( std::unique(boundaries.begin(), boundaries.end()), boundaries.end() );
+
+    // 2. Boundaries inside of other boundaries laid out together with them
+    //    (they may be even not laid out yet - if attached after last layout)
+    const auto nested = [&tree, &root, &boundaries](const uint64_t boundary) -> bool
+    {
+        auto parent = tree.tree.parent( taffy::NodeId{boundary} );
+        while( parent.is_some() && (parent.value() != root) )
+        {
+            if( std::binary_search(boundaries.begin(), boundaries.end(), static_cast<uint64_t>(parent.value())) ) {
+                return true;
+            }
+            parent = tree.tree.parent(parent.value());
+        }
+        return false;
+    };
+    std::vector<uint64_t> outermost;
+    outermost.reserve(boundaries.size());
+    for(const uint64_t boundary : boundaries)
+    {
+        if( !nested(boundary) ) {
+            outermost.push_back(boundary);
+        }
+    }
+
+    // 3. Layout of each boundary in place, at its previous size (flagged one,
+    //    which comes out at other size - whole tree). Then whole tree is up
+    //    to date: boundaries and their ancestors settled.
+    for(const uint64_t boundary : outermost)
+    {
+        if( !taffy_c_Taffy_compute_in_place(tree, taffy::NodeId{boundary}, true) ) {
+            return false;
+        }
+    }
+
+    for(const uint64_t boundary : outermost) {
+        taffy_c_Taffy_settle(tree, taffy::NodeId{boundary});
+    }
+    taffy_c_Taffy_prune_dirty_nodes(tree);
+
+    return true;
+}
+
+// Defined in 'Layout changes' section
+static void taffy_c_Taffy_track_begin(taffy_c::Taffy& tree, const taffy::NodeId& root);
+static void taffy_c_Taffy_track_end(taffy_c::Taffy& tree);
+static void taffy_c_Taffy_track_cancel(taffy_c::Taffy& tree);
+
+static taffy_TaffyResult_of_void taffy_c_Taffy_relayout(taffy_c::Taffy& tree, const taffy::NodeId& node, const taffy::Size<taffy::AvailableSpace>& available_space)
+{
+    taffy_c::Relayout& relayout = tree.relayout;
+
+    const bool same_layout = !relayout.full && relayout.computed &&
+        (relayout.root == static_cast<uint64_t>(node)) && (relayout.available_space == available_space);
+
+    if( same_layout && taffy_c_Taffy_relayout_boundaries(tree, node) )
+    {
+        relayout.changes.clear();
+        return taffy_TaffyResult_of_void_make_ok();
+    }
+
+    const auto result = taffy_c_Taffy_compute_root(tree, node, available_space);
+
+    if( result.is_ok() ) {
+        relayout.clear_settled(); // NOTE: settled nodes of other trees reported dirty again (as by taffy)
+    }
+
+    relayout.changes.clear();
+    relayout.full            = !result.is_ok();
+    relayout.computed        = result.is_ok();
+    relayout.root            = static_cast<uint64_t>(node);
+    relayout.available_space = available_space;
+
+    if( result.is_ok() ) {
+        relayout.root_spaces[ static_cast<uint64_t>(node) ] = available_space;
+    }
+
+    return taffy_TaffyResult_of_void_from_cpp(result);
+}
+
+// Entry point for all layout computations
+static taffy_TaffyResult_of_void taffy_c_Taffy_compute_layout(taffy_c::Taffy& tree, const taffy::NodeId& node, const taffy::Size<taffy::AvailableSpace>& available_space)
+{
+    taffy_c_Taffy_track_begin(tree, node);
+
+    const taffy_TaffyResult_of_void result = taffy_c_Taffy_relayout(tree, node, available_space);
+
+    taffy_c_Taffy_track_end(tree);
+
+    return result;
+}
+
+size_t taffy_Taffy_dirty_count(const taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+    tree.async.wait(); // cleaned by computation
+
+    return tree.dirty.count;
+}
+
+size_t taffy_Taffy_dirty_nodes(
+    const taffy_Taffy* self,
+
+    taffy_NodeId* out_nodes, size_t capacity
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+    tree.async.wait(); // cleaned by computation
+
+    const taffy_c::DirtyNodes& dirty = tree.dirty;
+
+    const size_t count = (dirty.count < capacity) ? dirty.count : capacity;
+    if(count > 0) {
+        ASSERT_NOT_NULL(out_nodes);
+    }
+
+    size_t written = 0;
+    for(size_t i = 0; (i < dirty.list.size()) && (written < count); ++i)
+    {
+        if(dirty.list[i].alive) {
+            out_nodes[written++].id = static_cast<uint64_t>(dirty.list[i].node);
+        }
+    }
+
+    return dirty.count;
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_compute_layout(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, const taffy_Size_of_AvailableSpace* available_space
+)
+{
+    ASSERT_NOT_NULL(self);
+    ASSERT_NOT_NULL(available_space);
+
+    const taffy::Size<taffy::AvailableSpace>* _available_space = reinterpret_cast<const taffy::Size<taffy::AvailableSpace>*>(available_space);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.async.drop();
+
+    return taffy_c_Taffy_compute_layout(
+        tree,
+        taffy::NodeId{node.id}, *_available_space
+    );
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_set_relayout_boundary(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, int is_boundary
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const taffy::NodeId _node { node.id };
+
+    if( !tree.contains(_node) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    if(is_boundary != 0) {
+        tree.data(_node).relayout_boundary = true;
+    } else {
+        taffy_c::NodeData* data = tree.find_mut(_node);
+        if(data != nullptr) {
+            data->relayout_boundary = false;
+        }
+    }
+
+    return taffy_TaffyResult_of_void_make_ok();
+}
+
+taffy_TaffyResult_of_Layout_const_ref taffy_Taffy_layout_resolved(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, const taffy_Size_of_AvailableSpace* root_space
+)
+{
+    ASSERT_NOT_NULL(self);
+    ASSERT_NOT_NULL(root_space);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.async.drop();
+
+    const taffy::NodeId _node { node.id };
+    const taffy::Size<taffy::AvailableSpace>& _root_space = *reinterpret_cast<const taffy::Size<taffy::AvailableSpace>*>(root_space);
+
+    if( !tree.contains(_node) ) {
+        taffy_TaffyResult_of_Layout_const_ref ret;
+        ret.error.type        = taffy_TaffyError_Type_InvalidInputNode;
+        ret.error.node        = node;
+        ret.error.child_index = 0;
+        ret.error.child_count = 0;
+        ret.value = nullptr;
+        return ret;
+    }
+
+    // Nearest relayout boundary above the node, and tree root
+    taffy::NodeId root     = _node;
+    bool          found    = false;
+    taffy::NodeId boundary = _node;
+    for(auto parent = tree.tree.parent(_node); parent.is_some(); parent = tree.tree.parent(root))
+    {
+        root = parent.value();
+
+        if( !found && taffy_c_Taffy_is_relayout_boundary(tree, root) ) {
+            found    = true;
+            boundary = root;
+        }
+    }
+
+    // Already up to date
+    const bool computed = tree.relayout.computed &&
+        (tree.relayout.root == static_cast<uint64_t>(root)) && (tree.relayout.available_space == _root_space);
+    if( computed && !tree.is_dirty(root) ) {
+        return taffy_c_Taffy_layout_result(tree, _node);
+    }
+
+    /*
+        Boundary with fixed size by style: layouts in its subtree (relative to
+        parents) depend only on the subtree itself, whatever changed outside
+        of it. Rounded ones depend on absolute position of the boundary too:
+        subtree rounded at its current one (from unrounded layouts of
+        ancestors), and rounded again by the next full pass, if it moves.
+        Flagged boundaries not taken: their size is kept only by whole tree
+        relayout (which checks all changes).
+    */
+    const auto fixed_boundary = [&tree](const taffy::NodeId& node) -> bool
+    {
+        const auto style = tree.tree.style(node);
+        return style.is_ok() && taffy_c_Style_is_fixed_size(style.value().get());
+    };
+
+    if( found && computed && fixed_boundary(boundary) )
+    {
+        if( !tree.is_dirty(boundary) ) {
+            return taffy_c_Taffy_layout_result(tree, _node); // changes are elsewhere
+        }
+
+        // All changes inside of boundary - whole tree relayout lays out again
+        // only it (and marks the tree up to date), so take it
+        const bool changes_inside = !tree.relayout.full && std::all_of(tree.relayout.changes.begin(), tree.relayout.changes.end(),
+            [&tree, &boundary](const taffy_c::Relayout::Record& record) -> bool
+            {
+                auto node = (record.change == taffy_c::Relayout::Change::Self) ?
+                    tree.tree.parent(record.node) : taffy::Option<taffy::NodeId>{record.node};
+                for(; node.is_some(); node = tree.tree.parent(node.value()))
+                {
+                    if( taffy_NodeId_eq(node.value(), boundary) ) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        );
+
+        if(!changes_inside)
+        {
+            // NOTE: ancestors stay dirty and changes stay recorded - laid out
+            // by the next full pass
+            taffy_c_Taffy_track_begin(tree, boundary);
+
+            const bool laid_out = taffy_c_Taffy_compute_in_place(tree, boundary, false);
+
+            taffy_c_Taffy_track_end(tree);
+
+            if(laid_out) {
+                return taffy_c_Taffy_layout_result(tree, _node);
+            }
+        }
+    }
+
+    // Whole tree (only boundaries with changes, if all changes inside of them)
+    const taffy_TaffyResult_of_void result = taffy_c_Taffy_compute_layout(tree, root, _root_space);
+    if(result.error.type != taffy_TaffyError_Type_Ok)
+    {
+        taffy_TaffyResult_of_Layout_const_ref ret;
+        ret.error = result.error;
+        ret.value = nullptr;
+        return ret;
+    }
+
+    return taffy_c_Taffy_layout_result(tree, _node);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_recompute_subtree(
+    taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.async.drop();
+
+    const taffy::NodeId _node { node.id };
+
+    if( !tree.contains(_node) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    taffy::NodeId root = _node;
+    for(auto parent = tree.tree.parent(_node); parent.is_some(); parent = tree.tree.parent(root)) {
+        root = parent.value();
+    }
+
+    const auto root_space = tree.relayout.root_spaces.find( static_cast<uint64_t>(root) );
+    if( root_space == tree.relayout.root_spaces.end() ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node.id = static_cast<uint64_t>(root); // never laid out
+        return ret;
+    }
+    const taffy::Size<taffy::AvailableSpace> available_space = root_space->second;
+
+    if(root != _node)
+    {
+        // NOTE: parent's real constraints for the node are not kept by taffy -
+        // only node, which size not depends on them, is laid out exactly
+        const auto style = tree.tree.style(_node);
+        if( !style.is_ok() || !taffy_c_Style_is_fixed_size(style.value().get()) ) {
+            taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+            ret.error.node = node;
+            return ret;
+        }
+
+        taffy_c_Taffy_track_begin(tree, _node);
+
+        const bool laid_out = taffy_c_Taffy_compute_in_place(tree, _node, false);
+
+        taffy_c_Taffy_track_end(tree);
+
+        if(laid_out) {
+            return taffy_TaffyResult_of_void_make_ok();
+        }
+
+        // Not laid out at its place yet (or failed): parent must lay it out
+        tree.tree.mark_dirty(_node);
+        tree.changed(_node);
+    }
+
+    return taffy_c_Taffy_compute_layout(tree, root, available_space);
+}
+
+// -----------------------------------------------------------------------------
+// Taffy :: multi-viewport layout
+
+// Pre-order list of nodes in subtree of 'root'
+static void taffy_c_Taffy_collect_subtree(const taffy_c::Taffy& tree, const taffy::NodeId& root, std::vector<taffy::NodeId>& nodes, std::vector<taffy::NodeId>& stack)
+{
+    nodes.clear();
+    stack.clear();
+    stack.push_back(root);
+
+    while( !stack.empty() )
+    {
+        const taffy::NodeId node = stack.back();
+        stack.pop_back();
+
+        nodes.push_back(node);
+
+        const auto count = tree.tree.child_count(node);
+        if( !count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = count.value(); i > 0; --i) // reversed - to pop them in order
+        {
+            const auto child = tree.tree.child_at_index(node, i - 1);
+            if( child.is_ok() ) {
+                stack.push_back(child.value());
+            }
+        }
+    }
+}
+
+static void taffy_c_Taffy_write_layouts(const taffy_c::Taffy& tree, const std::vector<taffy::NodeId>& nodes, taffy_LayoutBuffers& buffers)
+{
+    buffers.count = nodes.size();
+
+    const size_t count = (nodes.size() < buffers.capacity) ? nodes.size() : buffers.capacity;
+    for(size_t i = 0; i < count; ++i)
+    {
+        const taffy::Layout* layout = tree.layout(nodes[i]);
+        if(layout == nullptr) {
+            continue;
+        }
+        const taffy::Layout& l = *layout;
+
+        if(buffers.nodes  != nullptr) { buffers.nodes[i].id = static_cast<uint64_t>(nodes[i]); }
+        if(buffers.x      != nullptr) { buffers.x[i]        = l.location.x;                     }
+        if(buffers.y      != nullptr) { buffers.y[i]        = l.location.y;                     }
+        if(buffers.width  != nullptr) { buffers.width[i]    = l.size.width;                     }
+        if(buffers.height != nullptr) { buffers.height[i]   = l.size.height;                    }
+    }
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_compute_layout_multi(
+    taffy_Taffy* self,
+
+    taffy_NodeId root,
+    const taffy_Size_of_AvailableSpace* const* available_spaces, size_t count,
+    taffy_LayoutBuffers* buffers,
+    int restore
+)
+{
+    ASSERT_NOT_NULL(self);
+    if(count > 0) {
+        ASSERT_NOT_NULL(available_spaces);
+        ASSERT_NOT_NULL(buffers);
+    }
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.async.drop();
+
+    const taffy::NodeId _root { root.id };
+
+    if( !tree.contains(_root) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = root;
+        return ret;
+    }
+
+    // Tree structure is the same for all viewports - collected once
+    std::vector<taffy::NodeId> nodes;
+    std::vector<taffy::NodeId> stack;
+    taffy_c_Taffy_collect_subtree(tree, _root, nodes, stack);
+
+    taffy_c_Taffy_track_begin(tree, _root);
+
+    const bool can_restore = (restore != 0) && tree.relayout.computed && (tree.relayout.root == root.id);
+    const taffy::Size<taffy::AvailableSpace> previous = tree.relayout.available_space;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        ASSERT_NOT_NULL(available_spaces[i]);
+
+        const taffy::Size<taffy::AvailableSpace>& available_space = *reinterpret_cast<const taffy::Size<taffy::AvailableSpace>*>(available_spaces[i]);
+
+        const auto result = taffy_c_Taffy_compute_root(tree, _root, available_space);
+        if( !result.is_ok() ) {
+            tree.relayout.record_all();
+            taffy_c_Taffy_track_end(tree);
+            return taffy_TaffyResult_of_void_from_cpp(result);
+        }
+
+        taffy_c_Taffy_write_layouts(tree, nodes, buffers[i]);
+
+        // Relayout boundaries now refer to this layout
+        tree.relayout.changes.clear();
+        tree.relayout.full            = false;
+        tree.relayout.computed        = true;
+        tree.relayout.root            = root.id;
+        tree.relayout.available_space = available_space;
+
+        tree.relayout.root_spaces[root.id] = available_space;
+    }
+
+    // NOTE: inside of the same changes tracking scope
+    const taffy_TaffyResult_of_void result = (can_restore && (count > 0)) ?
+        taffy_c_Taffy_relayout(tree, _root, previous) : taffy_TaffyResult_of_void_make_ok();
+
+    taffy_c_Taffy_track_end(tree);
+
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Taffy :: per-node context
+
+taffy_TaffyResult_of_void taffy_Taffy_set_context(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, void* context
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const taffy::NodeId _node { node.id };
+    if( !tree.contains(_node) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    tree.data(_node).context = context;
+
+    return taffy_TaffyResult_of_void_make_ok();
+}
+
+void* taffy_Taffy_get_context(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    return reinterpret_cast<const taffy_c::Taffy*>(self)->context( taffy::NodeId{node.id} );
+}
+
+// -----------------------------------------------------------------------------
+// Reconciler
+
+namespace taffy_c {
+
+struct Reconciler
+{
+    struct Entry
+    {
+        taffy::NodeId node;
+        uint64_t      pass; // last 'reconcile()' pass, where key was present
+
+        Entry(taffy::NodeId node, uint64_t pass)
+            : node(node)
+            , pass(pass)
+        {}
+    };
+
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    taffy_c::Taffy* tree;
+
+    std::unordered_map<uint64_t, Entry> entries; // key -> node
+    uint64_t pass;
+
+    // Scratch storage, reused between passes (to not allocate on each pass)
+    std::unordered_map<uint64_t, size_t> item_index; // key -> item index
+    std::vector<taffy::NodeId> nodes;                 // item index -> node
+    std::vector<size_t> first_child;                  // item index -> first child item index
+    std::vector<size_t> last_child;                   // item index -> last child item index
+    std::vector<size_t> next_sibling;                 // item index -> next sibling item index
+    std::vector<size_t> changed;                      // items, which children list changed
+    std::vector<taffy::NodeId> children;
+
+    explicit Reconciler(taffy_c::Taffy* tree)
+        : tree(tree)
+        , entries()
+        , pass(0)
+    {}
+};
+
+constexpr size_t Reconciler::NONE;
+
+} // namespace taffy_c
+
+// Compare children of 'parent' in tree with desired children list, without
+// allocations (via 'child_count()' and 'child_at_index()')
+static bool taffy_Reconciler_children_equal(const taffy_c::Reconciler& r, size_t parent)
+{
+    const auto count = r.tree->tree.child_count(r.nodes[parent]);
+    if( !count.is_ok() ) {
+        return false;
+    }
+
+    size_t index = 0;
+    for(size_t child = r.first_child[parent]; child != taffy_c::Reconciler::NONE; child = r.next_sibling[child])
+    {
+        if(index >= count.value()) {
+            return false;
+        }
+
+        const auto current = r.tree->tree.child_at_index(r.nodes[parent], index);
+        if( !current.is_ok() || !taffy_NodeId_eq(current.value(), r.nodes[child]) ) {
+            return false;
+        }
+
+        ++index;
+    }
+
+    return index == count.value();
+}
+
+taffy_Reconciler* taffy_Reconciler_new(taffy_Taffy* tree)
+{
+    ASSERT_NOT_NULL(tree);
+
+    return reinterpret_cast<taffy_Reconciler*>(
+        new taffy_c::Reconciler{ reinterpret_cast<taffy_c::Taffy*>(tree) }
+    );
+}
+
+void taffy_Reconciler_delete(taffy_Reconciler* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    delete reinterpret_cast<taffy_c::Reconciler*>(self);
+    self = nullptr;
+}
+
+taffy_TaffyResult_of_NodeId taffy_Reconciler_reconcile(
+    taffy_Reconciler* self,
+
+    const taffy_ReconcileItem* items, size_t items_count
+)
+{
+    ASSERT_NOT_NULL(self);
+    if(items_count > 0) {
+        ASSERT_NOT_NULL(items);
+    }
+
+    taffy_c::Reconciler& r = *reinterpret_cast<taffy_c::Reconciler*>(self);
+    r.tree->async.wait();
+
+    if(items_count == 0) {
+        return taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+    }
+
+    // 1. Validate description, before any tree modification
+    r.item_index.clear();
+    for(size_t i = 0; i < items_count; ++i)
+    {
+        if(items[i].style == nullptr) {
+            return taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type_InvalidInputNode, i, items_count);
+        }
+
+        if(i > 0)
+        {
+            // Parent must be described before its children
+            if(r.item_index.find(items[i].parent_key) == r.item_index.end()) {
+                return taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type_InvalidParentNode, i, items_count);
+            }
+        }
+
+        if( !r.item_index.emplace(items[i].key, i).second ) {
+            return taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type_InvalidInputNode, i, items_count);
+        }
+    }
+
+    ++r.pass;
+
+    // 2. Resolve nodes: reuse existing (updating only changed styles), or create new ones
+    r.nodes.clear();
+    r.nodes.reserve(items_count);
+    for(size_t i = 0; i < items_count; ++i)
+    {
+        const taffy::Style& style = *reinterpret_cast<const taffy::Style*>(items[i].style);
+
+        auto found = r.entries.find(items[i].key);
+        if(found != r.entries.end())
+        {
+            const auto current = r.tree->tree.style(found->second.node);
+            if(current.is_ok())
+            {
+                if( !(current.value().get() == style) )
+                {
+                    if( r.tree->tree.set_style(found->second.node, style).is_ok() ) {
+                        r.tree->changed(found->second.node);
+                    }
+                }
+
+                found->second.pass = r.pass;
+                r.nodes.push_back(found->second.node);
+                continue;
+            }
+
+            // Node was removed from the tree outside of reconciler - forget it
+            r.entries.erase(found);
+        }
+
+        const auto created = r.tree->tree.new_leaf(style);
+        if( !created.is_ok() ) {
+            return taffy_TaffyResult_of_NodeId_from_cpp(created);
+        }
+
+        r.entries.emplace(items[i].key, taffy_c::Reconciler::Entry{ created.value(), r.pass });
+        r.nodes.push_back(created.value());
+    }
+
+    // 3. Remove nodes, which keys are not present anymore
+    for(auto it = r.entries.begin(); it != r.entries.end(); )
+    {
+        if(it->second.pass != r.pass)
+        {
+            r.tree->remove(it->second.node);
+            it = r.entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // 4. Build desired children lists (as index links - no per-parent vectors)
+    r.first_child .assign(items_count, taffy_c::Reconciler::NONE);
+    r.last_child  .assign(items_count, taffy_c::Reconciler::NONE);
+    r.next_sibling.assign(items_count, taffy_c::Reconciler::NONE);
+    for(size_t i = 1; i < items_count; ++i)
+    {
+        const size_t parent = r.item_index.find(items[i].parent_key)->second;
+
+        if(r.last_child[parent] == taffy_c::Reconciler::NONE) {
+            r.first_child[parent] = i;
+        } else {
+            r.next_sibling[ r.last_child[parent] ] = i;
+        }
+        r.last_child[parent] = i;
+    }
+
+    // 5. Apply changed children lists. Firstly detach children from all
+    //    changed parents, so moved nodes not lose their new parent, when old
+    //    parent processed later.
+    r.changed.clear();
+    for(size_t i = 0; i < items_count; ++i)
+    {
+        if( !taffy_Reconciler_children_equal(r, i) ) {
+            r.changed.push_back(i);
+        }
+    }
+
+    r.children.clear();
+    for(const size_t parent : r.changed)
+    {
+        if( r.tree->tree.set_children(r.nodes[parent], r.children).is_ok() ) {
+            r.tree->content_changed(r.nodes[parent]);
+        }
+    }
+
+    for(const size_t parent : r.changed)
+    {
+        r.children.clear();
+        for(size_t child = r.first_child[parent]; child != taffy_c::Reconciler::NONE; child = r.next_sibling[child]) {
+            r.children.push_back(r.nodes[child]);
+        }
+
+        const auto result = r.tree->tree.set_children(r.nodes[parent], r.children);
+        if( !result.is_ok() )
+        {
+            return taffy_TaffyResult_of_NodeId_from_cpp_error(result.error());
+        }
+        r.tree->reindex_children(r.nodes[parent], 0);
+    }
+
+    return taffy_TaffyResult_of_NodeId_make_ok(r.nodes[0]);
+}
+
+int taffy_Reconciler_find(
+    const taffy_Reconciler* self,
+
+    uint64_t key, taffy_NodeId* out_node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::Reconciler& r = *reinterpret_cast<const taffy_c::Reconciler*>(self);
+
+    const auto found = r.entries.find(key);
+    if(found == r.entries.end()) {
+        return 0; /* false */
+    }
+
+    if(out_node != nullptr) {
+        out_node->id = static_cast<uint64_t>(found->second.node);
+    }
+    return 1; /* true */
+}
+
+void taffy_Reconciler_clear(taffy_Reconciler* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    taffy_c::Reconciler& r = *reinterpret_cast<taffy_c::Reconciler*>(self);
+    r.tree->async.wait();
+
+    for(const auto& entry : r.entries) {
+        r.tree->remove(entry.second.node);
+    }
+    r.entries.clear();
+}
+
+// -----------------------------------------------------------------------------
+// TreeBuilder
+
+namespace taffy_c {
+
+struct TreeBuilder
+{
+    taffy_c::Taffy* tree;
+
+    std::vector<taffy::NodeId> stack; // currently open nodes
+
+    // Children of open nodes (by depth), attached once per node on its
+    // 'end_node()' - passed to taffy as is (no intermediate copy). Inner
+    // vectors kept between nodes to reuse capacity.
+    std::vector< taffy::Vec<taffy::NodeId> > children;
+
+    bool          has_root; // built (closed) root
+    taffy::NodeId root;
+
+    explicit TreeBuilder(taffy_c::Taffy* tree)
+        : tree(tree)
+        , stack()
+        , children()
+        , has_root(false)
+        , root( taffy::NodeId{0} )
+    {}
+};
+
+} // namespace taffy_c
+
+taffy_TreeBuilder* taffy_TreeBuilder_new(taffy_Taffy* tree)
+{
+    ASSERT_NOT_NULL(tree);
+
+    return reinterpret_cast<taffy_TreeBuilder*>(
+        new taffy_c::TreeBuilder{ reinterpret_cast<taffy_c::Taffy*>(tree) }
+    );
+}
+
+void taffy_TreeBuilder_delete(taffy_TreeBuilder* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    delete reinterpret_cast<taffy_c::TreeBuilder*>(self);
+    self = nullptr;
+}
+
+taffy_TaffyResult_of_NodeId taffy_TreeBuilder_begin_node(
+    taffy_TreeBuilder* self,
+
+    const taffy_Style* style
+)
+{
+    ASSERT_NOT_NULL(self);
+    ASSERT_NOT_NULL(style);
+
+    taffy_c::TreeBuilder& b = *reinterpret_cast<taffy_c::TreeBuilder*>(self);
+    b.tree->async.wait();
+
+    if(b.stack.empty() && b.has_root) {
+        return taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+    }
+
+    const auto created = b.tree->tree.new_leaf( *reinterpret_cast<const taffy::Style*>(style) );
+    if( !created.is_ok() ) {
+        return taffy_TaffyResult_of_NodeId_from_cpp(created);
+    }
+
+    b.stack.push_back(created.value());
+    if(b.children.size() < b.stack.size()) {
+        b.children.emplace_back();
+    }
+
+    return taffy_TaffyResult_of_NodeId_make_ok(created.value());
+}
+
+taffy_TaffyResult_of_void taffy_TreeBuilder_end_node(taffy_TreeBuilder* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    taffy_c::TreeBuilder& b = *reinterpret_cast<taffy_c::TreeBuilder*>(self);
+    b.tree->async.wait();
+
+    if(b.stack.empty()) {
+        return taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+    }
+
+    const size_t        depth = b.stack.size() - 1;
+    const taffy::NodeId node  = b.stack.back();
+
+    // Attach all collected children at once: node is not attached to parent
+    // yet, so its dirty marking does not walk up through ancestors
+    taffy::Vec<taffy::NodeId>& childs = b.children[depth];
+    if( !childs.empty() )
+    {
+        const auto result = b.tree->tree.set_children(node, childs);
+        if( !result.is_ok() ) {
+            return taffy_TaffyResult_of_void_from_cpp(result);
+        }
+        b.tree->reindex_children(node, 0);
+        childs.clear();
+    }
+
+    b.stack.pop_back();
+    if(depth > 0) {
+        b.children[depth - 1].push_back(node);
+    } else {
+        b.has_root = true;
+        b.root     = node;
+    }
+
+    return taffy_TaffyResult_of_void_make_ok();
+}
+
+taffy_TaffyResult_of_NodeId taffy_TreeBuilder_finish(taffy_TreeBuilder* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    taffy_c::TreeBuilder& b = *reinterpret_cast<taffy_c::TreeBuilder*>(self);
+
+    if( !b.stack.empty() || !b.has_root ) {
+        return taffy_TaffyResult_of_NodeId_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, b.stack.size());
+    }
+
+    b.has_root = false;
+
+    return taffy_TaffyResult_of_NodeId_make_ok(b.root);
+}
+
+size_t taffy_TreeBuilder_depth(const taffy_TreeBuilder* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    return reinterpret_cast<const taffy_c::TreeBuilder*>(self)->stack.size();
+}
+
+// -----------------------------------------------------------------------------
+// Layout visitor
+
+// Returns 'false' if walk must be stopped
+static bool taffy_Taffy_visit_layouts_recursive(
+    const taffy_c::Taffy& self,
+
+    taffy_LayoutVisit& visit, const taffy::Layout& layout,
+    float parent_abs_x, float parent_abs_y,
+    taffy_LayoutVisitor visitor, void* user_data
+)
+{
+    visit.order  = layout.order;
+    visit.x      = layout.location.x;
+    visit.y      = layout.location.y;
+    visit.width  = layout.size.width;
+    visit.height = layout.size.height;
+    visit.abs_x  = parent_abs_x + layout.location.x;
+    visit.abs_y  = parent_abs_y + layout.location.y;
+
+    const taffy::NodeId node { visit.node.id };
+
+    const taffy_c::NodeData* data = self.find(node);
+    visit.context    = (data != nullptr) ? data->context           : nullptr;
+    visit.generation = self.layout_changes.generation(node);
+
+    const int action = visitor(&visit, user_data);
+    if(action == taffy_VisitAction_Stop) {
+        return false;
+    }
+    if(action == taffy_VisitAction_SkipChildren) {
+        return true;
+    }
+
+    const taffy::Taffy& tree = self.tree;
+
+    const auto count = tree.child_count(node);
+    if( !count.is_ok() ) {
+        return true;
+    }
+
+    // Per-level state, restored after children visiting (visit struct reused)
+    const taffy_NodeId node_id = visit.node;
+    const taffy_NodeId parent  = visit.parent;
+    const size_t       depth   = visit.depth;
+    const float        abs_x   = visit.abs_x;
+    const float        abs_y   = visit.abs_y;
+
+    bool proceed = true;
+    for(size_t i = 0; (i < count.value()) && proceed; ++i)
+    {
+        const auto child = tree.child_at_index(node, i);
+        if( !child.is_ok() ) {
+            continue;
+        }
+
+        const taffy::Layout* child_layout = self.layout(child.value());
+        if(child_layout == nullptr) {
+            continue;
+        }
+
+        visit.node.id = static_cast<uint64_t>( child.value() );
+        visit.parent  = node_id;
+        visit.depth   = depth + 1;
+
+        proceed = taffy_Taffy_visit_layouts_recursive(self, visit, *child_layout, abs_x, abs_y, visitor, user_data);
+    }
+
+    visit.node   = node_id;
+    visit.parent = parent;
+    visit.depth  = depth;
+
+    return proceed;
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_visit_layouts(
+    const taffy_Taffy* self,
+
+    taffy_NodeId root, taffy_LayoutVisitor visitor, void* user_data
+)
+{
+    ASSERT_NOT_NULL(self);
+    ASSERT_NOT_NULL(visitor);
+
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+    tree.async.wait(); // live layouts and generations written by computation
+
+    const taffy::Layout* layout = tree.layout( taffy::NodeId{root.id} );
+    if(layout == nullptr)
+    {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = root;
+        return ret;
+    }
+
+    taffy_LayoutVisit visit;
+    visit.node   = root;
+    visit.parent = root;
+    visit.depth  = 0;
+
+    taffy_Taffy_visit_layouts_recursive(tree, visit, *layout, 0.0f, 0.0f, visitor, user_data);
+
+    return taffy_TaffyResult_of_void_make_ok();
+}
+
+// -----------------------------------------------------------------------------
+// Traversal
+
+static bool taffy_Taffy_sibling(const taffy_c::Taffy& tree, const taffy::NodeId node, const bool next, taffy_NodeId* out_node)
+{
+    const taffy::Option<taffy::NodeId> parent = tree.tree.parent(node);
+    if( !parent.is_some() ) {
+        return false;
+    }
+
+    const size_t i = tree.child_index(node); // O(1), unless index is stale
+    if( !next && (i == 0) ) {
+        return false;
+    }
+
+    const auto sibling = tree.tree.child_at_index(parent.value(), next ? (i + 1) : (i - 1));
+    if( !sibling.is_ok() ) {
+        return false; // the last one
+    }
+
+    if(out_node != nullptr) {
+        out_node->id = static_cast<uint64_t>( sibling.value() );
+    }
+    return true;
+}
+
+int taffy_Taffy_parent(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node, taffy_NodeId* out_node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy::Option<taffy::NodeId> parent = reinterpret_cast<const taffy_c::Taffy*>(self)->tree.parent(
+        taffy::NodeId{node.id}
+    );
+
+    if( !parent.is_some() ) {
+        return 0; /* false */
+    }
+
+    if(out_node != nullptr) {
+        out_node->id = static_cast<uint64_t>( parent.value() );
+    }
+    return 1; /* true */
+}
+
+int taffy_Taffy_next_sibling(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node, taffy_NodeId* out_node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    return taffy_Taffy_sibling(*reinterpret_cast<const taffy_c::Taffy*>(self), taffy::NodeId{node.id}, true, out_node) ? 1 : 0;
+}
+
+int taffy_Taffy_prev_sibling(
+    const taffy_Taffy* self,
+
+    taffy_NodeId node, taffy_NodeId* out_node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    return taffy_Taffy_sibling(*reinterpret_cast<const taffy_c::Taffy*>(self), taffy::NodeId{node.id}, false, out_node) ? 1 : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// TreeIter
+
+// Frame 'child_index' marker: node is pushed, but not entered yet
+static const size_t TAFFY_TREE_ITER_NOT_ENTERED = static_cast<size_t>(-1);
+
+// Frame 'child_index' marker: children of entered node must be skipped
+static const size_t TAFFY_TREE_ITER_SKIP = static_cast<size_t>(-2);
+
+void taffy_TreeIter_init(
+    taffy_TreeIter* self,
+
+    const taffy_Taffy* tree, taffy_NodeId root, taffy_TreeIter_Order order,
+    taffy_TreeIter_Frame* stack, size_t stack_capacity
+)
+{
+    ASSERT_NOT_NULL(self);
+    ASSERT_NOT_NULL(tree);
+    if(stack_capacity > 0) {
+        ASSERT_NOT_NULL(stack);
+    }
+
+    self->tree           = tree;
+    self->order          = order;
+    self->stack          = stack;
+    self->stack_capacity = stack_capacity;
+    self->stack_size     = 0;
+    self->overflow       = 0; /* false */
+
+    if(stack_capacity == 0)
+    {
+        self->overflow = 1; /* true */
+        return;
+    }
+
+    self->stack[0].node        = root;
+    self->stack[0].child_index = TAFFY_TREE_ITER_NOT_ENTERED;
+    self->stack_size           = 1;
+}
+
+int taffy_TreeIter_next(taffy_TreeIter* self, taffy_NodeId* out_node, size_t* out_depth)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy::Taffy& tree = reinterpret_cast<const taffy_c::Taffy*>(self->tree)->tree;
+
+    while(self->stack_size > 0)
+    {
+        taffy_TreeIter_Frame& top = self->stack[self->stack_size - 1];
+
+        if(top.child_index == TAFFY_TREE_ITER_NOT_ENTERED)
+        {
+            top.child_index = 0;
+
+            if(self->order == taffy_TreeIter_Order_PreOrder)
+            {
+                if(out_node  != nullptr) { *out_node  = top.node;             }
+                if(out_depth != nullptr) { *out_depth = self->stack_size - 1; }
+                return 1; /* true */
+            }
+        }
+
+        const taffy::NodeId node { top.node.id };
+
+        const auto count = tree.child_count(node);
+        if( (top.child_index != TAFFY_TREE_ITER_SKIP) && count.is_ok() && (top.child_index < count.value()) )
+        {
+            const auto child = tree.child_at_index(node, top.child_index);
+            ++top.child_index;
+
+            if( !child.is_ok() ) {
+                continue;
+            }
+
+            if(self->stack_size == self->stack_capacity)
+            {
+                self->overflow   = 1; /* true */
+                self->stack_size = 0;
+                return 0; /* false */
+            }
+
+            taffy_TreeIter_Frame& pushed = self->stack[self->stack_size];
+            pushed.node.id     = static_cast<uint64_t>( child.value() );
+            pushed.child_index = TAFFY_TREE_ITER_NOT_ENTERED;
+            ++self->stack_size;
+
+            continue;
+        }
+
+        // All children visited - leave node
+        --self->stack_size;
+
+        if(self->order == taffy_TreeIter_Order_PostOrder)
+        {
+            if(out_node  != nullptr) { *out_node  = top.node;         }
+            if(out_depth != nullptr) { *out_depth = self->stack_size; }
+            return 1; /* true */
+        }
+    }
+
+    return 0; /* false */
+}
+
+void taffy_TreeIter_skip_children(taffy_TreeIter* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    if( (self->order == taffy_TreeIter_Order_PreOrder) && (self->stack_size > 0) ) {
+        self->stack[self->stack_size - 1].child_index = TAFFY_TREE_ITER_SKIP;
+    }
+}
+
+int taffy_TreeIter_overflowed(const taffy_TreeIter* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    return self->overflow;
+}
+
+// -----------------------------------------------------------------------------
+// ThreadPool
+
+namespace taffy_c {
+
+/*
+    Work-stealing pool: for each 'parallel_for()' call, indices range split
+    evenly between participants (workers and calling thread). Each participant
+    takes indices from the front of its own range, and when it is exhausted -
+    steals upper half of the largest remaining range of another participant.
+*/
+class ThreadPool
+{
+    struct Range
+    {
+        std::mutex mutex;
+        size_t     begin;
+        size_t     end;
+
+        Range()
+            : mutex()
+            , begin(0)
+            , end(0)
+        {}
+    };
+
+    std::vector<std::thread> _threads;
+    std::unique_ptr<Range[]> _ranges; // per participant, last one - for calling thread
+
+    std::mutex              _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+
+    const std::function<void(size_t)>* _task;
+    size_t _generation;
+    size_t _active;
+    bool   _stop;
+
+    std::mutex _run_mutex; // 'parallel_for()' calls are serialized
+
+    // Pool, which task is running on current thread (to detect nested calls)
+    static thread_local const ThreadPool* _current;
+
+    bool pop(size_t slot, size_t& index)
+    {
+        Range& range = _ranges[slot];
+
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if(range.begin == range.end) {
+            return false;
+        }
+        index = range.begin++;
+        return true;
+    }
+
+    // Takes upper half of the largest remaining range of other participant.
+    // Returns 'false' if there is nothing to steal.
+    bool steal(size_t slot, size_t& index)
+    {
+        const size_t slots = _threads.size() + 1;
+
+        for(;;)
+        {
+            // NOTE: approximate, since ranges are changing concurrently
+            size_t victim    = slot;
+            size_t remaining = 0;
+            for(size_t i = 1; i < slots; ++i)
+            {
+                const size_t other = (slot + i) % slots;
+
+                std::lock_guard<std::mutex> lock(_ranges[other].mutex);
+                const size_t size = _ranges[other].end - _ranges[other].begin;
+                if(size > remaining)
+                {
+                    victim    = other;
+                    remaining = size;
+                }
+            }
+            if(victim == slot) {
+                return false;
+            }
+
+            size_t begin = 0;
+            size_t end   = 0;
+            {
+                Range& range = _ranges[victim];
+
+                std::lock_guard<std::mutex> lock(range.mutex);
+                if(range.begin == range.end) {
+                    continue; // lost the race - look for other victim
+                }
+
+                begin = range.begin + (range.end - range.begin) / 2;
+                end   = range.end;
+                range.end = begin;
+            }
+
+            {
+                Range& range = _ranges[slot];
+
+                std::lock_guard<std::mutex> lock(range.mutex);
+                range.begin = begin + 1;
+                range.end   = end;
+            }
+
+            index = begin;
+            return true;
+        }
+    }
+
+    void run(size_t slot)
+    {
+        const ThreadPool* previous = _current;
+        _current = this;
+
+        size_t index = 0;
+        while( pop(slot, index) || steal(slot, index) ) {
+            (*_task)(index);
+        }
+
+        _current = previous;
+    }
+
+    void worker(size_t slot)
+    {
+        size_t seen = 0;
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this, seen]() { return _stop || (_generation != seen); });
+                if(_stop) {
+                    return;
+                }
+                seen = _generation;
+            }
+
+            run(slot);
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if(--_active == 0) {
+                    _done.notify_all();
+                }
+            }
+        }
+    }
+
+public:
+
+    explicit ThreadPool(size_t threads_count)
+        : _threads()
+        , _ranges( new Range[threads_count + 1] )
+        , _mutex()
+        , _wake()
+        , _done()
+        , _task(nullptr)
+        , _generation(0)
+        , _active(0)
+        , _stop(false)
+        , _run_mutex()
+    {
+        _threads.reserve(threads_count);
+        for(size_t i = 0; i < threads_count; ++i) {
+            _threads.emplace_back(&ThreadPool::worker, this, i);
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+
+        for(std::thread& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+    size_t threads_count() const
+    {
+        return _threads.size();
+    }
+
+    // Calls 'task(index)' for each index in [0, count) range, returns when all
+    // calls are done. Nested calls (from within task) are done serially.
+    void parallel_for(size_t count, const std::function<void(size_t)>& task)
+    {
+        if( _threads.empty() || (count <= 1) || (_current == this) )
+        {
+            for(size_t i = 0; i < count; ++i) {
+                task(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(_run_mutex);
+
+        const size_t slots = _threads.size() + 1;
+        for(size_t slot = 0; slot < slots; ++slot)
+        {
+            std::lock_guard<std::mutex> lock(_ranges[slot].mutex);
+            _ranges[slot].begin = (count *  slot     ) / slots;
+            _ranges[slot].end   = (count * (slot + 1)) / slots;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task   = &task;
+            _active = _threads.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        run(_threads.size());
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this]() { return _active == 0; });
+            _task = nullptr;
+        }
+    }
+};
+
+thread_local const ThreadPool* ThreadPool::_current = nullptr;
+
+} // namespace taffy_c
+
+taffy_ThreadPool* taffy_ThreadPool_new(size_t threads_count)
+{
+    return reinterpret_cast<taffy_ThreadPool*>( new taffy_c::ThreadPool(threads_count) );
+}
+
+taffy_ThreadPool* taffy_ThreadPool_new_default(void)
+{
+    const size_t concurrency = std::thread::hardware_concurrency(); // may be 0, if unknown
+
+    return taffy_ThreadPool_new( (concurrency > 1) ? (concurrency - 1) : 0 );
+}
+
+void taffy_ThreadPool_delete(taffy_ThreadPool* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    delete reinterpret_cast<taffy_c::ThreadPool*>(self);
+}
+
+size_t taffy_ThreadPool_threads_count(const taffy_ThreadPool* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    return reinterpret_cast<const taffy_c::ThreadPool*>(self)->threads_count();
+}
+
+void taffy_compute_layouts_parallel(
+    taffy_Taffy* const*                        trees,
+    const taffy_NodeId*                        roots,
+    const taffy_Size_of_AvailableSpace* const* available_spaces,
+    size_t                                     count,
+
+    taffy_ThreadPool*          pool,
+    taffy_TaffyResult_of_void* results
+)
+{
+    if(count == 0) {
+        return;
+    }
+
+    ASSERT_NOT_NULL(trees);
+    ASSERT_NOT_NULL(roots);
+    ASSERT_NOT_NULL(available_spaces);
+    ASSERT_NOT_NULL(results);
+
+    // Asynchronous computations (and their published layouts) dropped on
+    // calling thread, as by 'taffy_Taffy_compute_layout()' - before tasks
+    // mutate the trees
+    for(size_t i = 0; i < count; ++i)
+    {
+        ASSERT_NOT_NULL(trees[i]);
+        ASSERT_NOT_NULL(available_spaces[i]);
+
+        reinterpret_cast<taffy_c::Taffy*>(trees[i])->async.drop();
+    }
+
+    // NOTE: each tree keeps its own scratch data (batch measure buffers, etc),
+    // so tasks share nothing and results written into distinct slots
+    const std::function<void(size_t)> task = [trees, roots, available_spaces, results](size_t i)
+    {
+
+        results[i] = taffy_c_Taffy_compute_layout(
+            *reinterpret_cast<taffy_c::Taffy*>(trees[i]),
+            taffy::NodeId{ roots[i].id },
+            *reinterpret_cast<const taffy::Size<taffy::AvailableSpace>*>(available_spaces[i])
+        );
+    };
+
+    if(pool == nullptr)
+    {
+        for(size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    reinterpret_cast<taffy_c::ThreadPool*>(pool)->parallel_for(count, task);
+}
+
+// -----------------------------------------------------------------------------
+// Parallel layout
+
+// Available space, at which subtree of 'node' may be laid out independently
+// of the rest of the tree. Returns 'false' if node is not such subtree root.
+static bool taffy_c_Taffy_independent_space(const taffy_c::Taffy& tree, const taffy::NodeId& node, taffy::Size<taffy::AvailableSpace>& available_space)
+{
+    const auto style_result = tree.tree.style(node);
+    if( !style_result.is_ok() ) {
+        return false;
+    }
+    const taffy::Style& style = style_result.value().get();
+
+    if(style.display.type() == taffy::Display::Type::None) {
+        return false;
+    }
+
+    // Percentages of padding and border resolved against parent size - content
+    // of node depends on them (even if hinted)
+    const bool length_insets =
+        (style.padding.left  .type() == taffy::LengthPercentage::Type::Length) &&
+        (style.padding.right .type() == taffy::LengthPercentage::Type::Length) &&
+        (style.padding.top   .type() == taffy::LengthPercentage::Type::Length) &&
+        (style.padding.bottom.type() == taffy::LengthPercentage::Type::Length) &&
+        (style.border.left   .type() == taffy::LengthPercentage::Type::Length) &&
+        (style.border.right  .type() == taffy::LengthPercentage::Type::Length) &&
+        (style.border.top    .type() == taffy::LengthPercentage::Type::Length) &&
+        (style.border.bottom .type() == taffy::LengthPercentage::Type::Length);
+    if(!length_insets) {
+        return false;
+    }
+
+    // Own size not depends on parent (also not flexed by it)
+    const bool independent = taffy_c_Style_is_fixed_size(style);
+
+    if(!independent)
+    {
+        const taffy_c::NodeData* data = tree.find(node);
+        if( (data == nullptr) || !data->parallel_hint ) {
+            return false;
+        }
+    }
+
+    if(independent)
+    {
+        available_space = taffy::Size<taffy::AvailableSpace>{
+            taffy::AvailableSpace::Definite(style.size.width .value()),
+            taffy::AvailableSpace::Definite(style.size.height.value())
+        };
+        return true;
+    }
+
+    // Hinted node: laid out at its previous (unrounded, see 'Rounding'
+    // section) size. Only a guess - if parent gives other size, serial pass
+    // lays it out again.
+    const auto layout = tree.tree.layout(node);
+    if( !layout.is_ok() ) {
+        return false;
+    }
+    if( !tree.is_laid_out(node) ) {
+        return false;
+    }
+    const taffy::Size<float>& size = layout.value().get().size;
+
+    available_space = taffy::Size<taffy::AvailableSpace>{
+        taffy::AvailableSpace::Definite(size.width),
+        taffy::AvailableSpace::Definite(size.height)
+    };
+    return true;
+}
+
+// Subtree of 'root' is worth a task (has at least 'min_nodes' nodes), and
+// may be laid out on pool thread (no user measure functions in it, unless
+// they are thread-safe)
+static bool taffy_c_Taffy_is_parallel_unit(const taffy_c::Taffy& tree, const taffy::NodeId& root, size_t min_nodes, std::vector<taffy::NodeId>& stack)
+{
+    const bool concurrent_measure = tree.parallel.concurrent_measure;
+
+    stack.clear();
+    stack.push_back(root);
+
+    size_t visited = 0;
+    while( !stack.empty() )
+    {
+        const taffy::NodeId node = stack.back();
+        stack.pop_back();
+
+        if(!concurrent_measure)
+        {
+            // NOTE: fixed text measured by binding itself (per-node state)
+            const taffy_c::NodeData* data = tree.find(node);
+            if( (data != nullptr) && (data->measure != nullptr) ) {
+                return false;
+            }
+        }
+
+        if( (++visited >= min_nodes) && concurrent_measure ) {
+            return true; // rest of subtree not checked
+        }
+
+        const auto children_count = tree.tree.child_count(node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(node, i);
+            if( child.is_ok() ) {
+                stack.push_back(child.value());
+            }
+        }
+    }
+
+    return visited >= min_nodes;
+}
+
+/*
+    Lays out dirty independent subtrees (see 'taffy_c_Taffy_independent_space()')
+    concurrently, each one as separate root. Following serial layout of the
+    whole tree takes their results from taffy cache, or recomputes them, if
+    parent gives them other size - so final result is the same as without this
+    pass.
+
+    Thread safety: taffy_cpp does not document concurrent computations on
+    one 'taffy::Taffy' - this pass relies on its current implementation:
+    - computation of subtree reads only styles and children lists, and writes
+      only per-node layouts and caches of nodes in the subtree - distinct
+      objects, in storage not reallocated while tree is not mutated;
+    - taffy's own rounding (which writes whole tree) is not done - always
+      disabled, see 'Rounding' section.
+    Binding's part of preconditions:
+    - subtrees are disjoint (walk not enters found subtree);
+    - tree is not mutated during the pass (asserted): measure functions must
+      not mutate it;
+    - user measure functions are called on pool threads only if they are
+      declared thread-safe ('taffy_Taffy_set_parallel_measure()'); they get
+      their own node data ('NodeData' allocated before the pass), shared
+      measure cache counters are atomic.
+    Checked by parallel vs serial test in 'c/tests/test.c' - not a proof.
+*/
+static void taffy_c_Taffy_precompute_subtrees(taffy_c::Taffy& tree, const taffy::NodeId& root)
+{
+    taffy_c::ParallelLayout& parallel = tree.parallel;
+
+    parallel.units.clear();
+    parallel.walk.clear();
+    parallel.walk.push_back(root);
+
+    while( !parallel.walk.empty() )
+    {
+        const taffy::NodeId node = parallel.walk.back();
+        parallel.walk.pop_back();
+
+        // NOTE: dirtiness propagated up to the root, so clean node has clean subtree
+        const auto dirty = tree.tree.dirty(node);
+        if( !dirty.is_ok() || !dirty.value() ) {
+            continue;
+        }
+
+        taffy::Size<taffy::AvailableSpace> available_space { taffy::AvailableSpace::MaxContent(), taffy::AvailableSpace::MaxContent() };
+        if( (node != root) && taffy_c_Taffy_independent_space(tree, node, available_space) )
+        {
+            // Small subtree not worth a task (and subtrees in it are even
+            // smaller); subtree with user measure functions - laid out by
+            // serial pass
+            if( taffy_c_Taffy_is_parallel_unit(tree, node, parallel.min_subtree_nodes, parallel.stack) ) {
+                parallel.units.push_back( taffy_c::ParallelLayout::Unit{ node, available_space } );
+            }
+            continue;
+        }
+
+        const auto children_count = tree.tree.child_count(node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(node, i);
+            if( child.is_ok() ) {
+                parallel.walk.push_back(child.value());
+            }
+        }
+    }
+
+    if(parallel.units.size() < 2) {
+        return; // nothing to do in parallel - serial pass will do it
+    }
+
+    // NOTE: subtrees are laid out unrounded (taffy's own rounding disabled) -
+    // the same as serial pass leaves them before rounding of the whole tree
+    const std::vector<taffy_c::ParallelLayout::Unit>& units = parallel.units;
+
+    const uint64_t mutations = tree.relayout.mutations;
+    const size_t   slots     = tree.slots.size();
+
+    parallel.pool->parallel_for(units.size(), [&tree, &units](size_t i)
+    {
+        tree.tree.compute_layout(units[i].node, units[i].available_space);
+    });
+
+    // Not mutated during the pass (by measure function) - so storage was
+    // not reallocated under other tasks
+    assert( (tree.relayout.mutations == mutations) && (tree.slots.size() == slots) );
+    (void)mutations;
+    (void)slots;
+}
+
+void taffy_Taffy_set_parallel_layout(
+    taffy_Taffy* self,
+
+    taffy_ThreadPool* pool, size_t min_subtree_nodes
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::ParallelLayout& parallel = reinterpret_cast<taffy_c::Taffy*>(self)->parallel;
+    parallel.pool              = reinterpret_cast<taffy_c::ThreadPool*>(pool);
+    parallel.min_subtree_nodes = min_subtree_nodes;
+}
+
+void taffy_Taffy_set_parallel_measure(taffy_Taffy* self, int thread_safe)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    reinterpret_cast<taffy_c::Taffy*>(self)->parallel.concurrent_measure = (thread_safe != 0);
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_set_parallel_hint(
+    taffy_Taffy* self,
+
+    taffy_NodeId node, int hint
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+
+    const taffy::NodeId _node { node.id };
+
+    if( !tree.contains(_node) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    if(hint != 0) {
+        tree.data(_node).parallel_hint = true;
+    } else {
+        taffy_c::NodeData* data = tree.find_mut(_node);
+        if(data != nullptr) {
+            data->parallel_hint = false;
+        }
+    }
+
+    return taffy_TaffyResult_of_void_make_ok();
+}
+
+// -----------------------------------------------------------------------------
+// Time-budgeted layout
+
+// Drops state of in-progress time-budgeted layout, with its changes tracking
+static void taffy_c_Taffy_abandon_step(taffy_c::Taffy& tree)
+{
+    if(tree.stepper.active) {
+        taffy_c_Taffy_track_cancel(tree);
+    }
+    tree.stepper.abandon();
+}
+
+// Dirty independent subtrees of 'root' (including nested), deepest first
+static void taffy_c_Taffy_collect_step_units(taffy_c::Taffy& tree, const taffy::NodeId& root)
+{
+    taffy_c::LayoutStepper& stepper = tree.stepper;
+
+    stepper.units.clear();
+    stepper.walk.clear();
+    stepper.walk.push_back(root);
+
+    while( !stepper.walk.empty() )
+    {
+        const taffy::NodeId node = stepper.walk.back();
+        stepper.walk.pop_back();
+
+        const auto dirty = tree.tree.dirty(node);
+        if( !dirty.is_ok() || !dirty.value() ) {
+            continue;
+        }
+
+        taffy::Size<taffy::AvailableSpace> available_space { taffy::AvailableSpace::MaxContent(), taffy::AvailableSpace::MaxContent() };
+        if( (node != root) && taffy_c_Taffy_independent_space(tree, node, available_space) ) {
+            stepper.units.push_back( taffy_c::LayoutStepper::Unit{ node, available_space } );
+        }
+
+        const auto children_count = tree.tree.child_count(node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(node, i);
+            if( child.is_ok() ) {
+                stepper.walk.push_back(child.value());
+            }
+        }
+    }
+
+    // Pre-order reversed: nested subtrees before enclosing ones, so enclosing
+    // subtree takes their results from cache
+    std::reverse(stepper.units.begin(), stepper.units.end());
+}
+
+// Defined in 'Asynchronous layout' section
+static void taffy_c_Taffy_publish_layouts(taffy_c::Taffy& tree, const taffy::NodeId& root);
+
+taffy_TaffyResult_of_void taffy_Taffy_compute_layout_step(
+    taffy_Taffy* self,
+
+    taffy_NodeId root,
+    const taffy_Size_of_AvailableSpace* available_space,
+    uint64_t budget_ns,
+    taffy_LayoutStep* step
+)
+{
+    ASSERT_NOT_NULL(self);
+    ASSERT_NOT_NULL(available_space);
+    ASSERT_NOT_NULL(step);
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start = clock::now();
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    taffy_c::LayoutStepper& stepper = tree.stepper;
+    tree.async.wait(); // published layouts kept - see below
+    tree.async.reclaim();
+
+    const taffy::NodeId _root { root.id };
+    const taffy::Size<taffy::AvailableSpace>& _available_space = *reinterpret_cast<const taffy::Size<taffy::AvailableSpace>*>(available_space);
+
+    step->done     = 0;
+    step->progress = 0.0f;
+
+    if( !tree.contains(_root) ) {
+        taffy_c_Taffy_abandon_step(tree);
+
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = root;
+        return ret;
+    }
+
+    const bool same =
+        stepper.active &&
+        (stepper.root == root.id) &&
+        (stepper.available_space == _available_space) &&
+        (stepper.mutations == tree.relayout.mutations);
+
+    if(!same)
+    {
+        // Restart: tracking of previous computation dropped, layouts before
+        // the first step (after restart) are 'previous' ones for changes report
+        taffy_c_Taffy_abandon_step(tree);
+        taffy_c_Taffy_track_begin(tree, _root);
+
+        // NOTE: subtrees laid out before restart are clean now - not collected again
+        taffy_c_Taffy_collect_step_units(tree, _root);
+
+        // Units are laid out as roots (at 0, 0) - until done, layouts are
+        // served from copy of the last consistent ones (as by asynchronous
+        // layout). Already published (by not finished computation, or
+        // asynchronous one) - kept. No units - done by this call.
+        if( !stepper.units.empty() && (tree.async.front.load() == nullptr) ) {
+            taffy_c_Taffy_publish_layouts(tree, _root);
+        }
+
+        stepper.active          = true;
+        stepper.root            = root.id;
+        stepper.available_space = _available_space;
+        stepper.mutations       = tree.relayout.mutations;
+        stepper.next            = 0;
+    }
+
+    const auto elapsed_ns = [&start]() -> uint64_t
+    {
+        return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() );
+    };
+
+    bool worked = false;
+
+    if(stepper.next < stepper.units.size())
+    {
+        // Subtrees are laid out unrounded - whole tree rounded by last step
+        const bool rounding = tree.rounding;
+        tree.rounding = false;
+
+        while( (stepper.next < stepper.units.size()) && (!worked || (elapsed_ns() < budget_ns)) )
+        {
+            const taffy_c::LayoutStepper::Unit& unit = stepper.units[stepper.next];
+
+            // Result ignored: on error last step reports it for the whole tree
+            taffy_c_Taffy_compute_root(tree, unit.node, unit.available_space);
+
+            ++stepper.next;
+            worked = true;
+        }
+
+        tree.rounding = rounding;
+    }
+
+    const size_t steps_count = stepper.units.size() + 1; // + whole tree
+
+    if( worked && (elapsed_ns() >= budget_ns) )
+    {
+        step->progress = static_cast<float>(stepper.next) / static_cast<float>(steps_count);
+        return taffy_TaffyResult_of_void_make_ok();
+    }
+
+    // Subtrees own layouts (positions in parents) are not valid until their
+    // parents laid out, so relayout boundaries not enough. And they are clean
+    // now, so not recorded for dirty-only rounding - the whole tree rounded.
+    const bool dirty_only_rounding = tree.rounding_pass.dirty_only;
+    if( !stepper.units.empty() ) {
+        tree.relayout.full = true;
+        tree.rounding_pass.dirty_only = false;
+    }
+
+    stepper.abandon(); // NOTE: tracking scope ended by whole tree layout
+
+    step->done     = 1;
+    step->progress = 1.0f;
+
+    const taffy_TaffyResult_of_void result = taffy_c_Taffy_compute_layout(tree, _root, _available_space);
+
+    tree.rounding_pass.dirty_only = dirty_only_rounding;
+
+    tree.async.drop(); // back to live layouts
+
+    return result;
+}
+
+void taffy_Taffy_compute_layout_abandon(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c_Taffy_abandon_step( *reinterpret_cast<taffy_c::Taffy*>(self) );
+}
+
+// -----------------------------------------------------------------------------
+// Asynchronous layout
+
+// Copies layouts of subtree of 'root' into new buffer and publishes it
+static void taffy_c_Taffy_publish_layouts(taffy_c::Taffy& tree, const taffy::NodeId& root)
+{
+    taffy_c::AsyncLayout& async = tree.async;
+
+    taffy_c::LayoutBuffer* buffer = async.take_spare();
+
+    std::vector<taffy::NodeId>& walk = async.walk;
+    walk.clear();
+    walk.push_back(root);
+    while( !walk.empty() )
+    {
+        const taffy::NodeId node = walk.back();
+        walk.pop_back();
+
+        const taffy::Layout* layout = tree.layout(node);
+        if(layout == nullptr) {
+            continue;
+        }
+        buffer->store(node, *layout);
+
+        const auto children_count = tree.tree.child_count(node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(node, i);
+            if( child.is_ok() ) {
+                walk.push_back(child.value());
+            }
+        }
+    }
+
+    async.publish(buffer);
+}
+
+void taffy_Taffy_compute_layout_async(
+    taffy_Taffy* self,
+
+    taffy_NodeId root,
+    const taffy_Size_of_AvailableSpace* available_space,
+    taffy_LayoutDoneFunc on_done, void* user_data
+)
+{
+    ASSERT_NOT_NULL(self);
+    ASSERT_NOT_NULL(available_space);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    taffy_c::AsyncLayout& async = tree.async;
+
+    async.wait();
+    async.reclaim();
+
+    const taffy::NodeId _root { root.id };
+
+    if( !tree.contains(_root) )
+    {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = root;
+
+        async.set_result(ret);
+        if(on_done != nullptr) {
+            on_done(self, root, ret, user_data);
+        }
+        return;
+    }
+
+    // Live layouts are written during computation - readers switched to
+    // their copy
+    if(async.front.load() == nullptr) {
+        taffy_c_Taffy_publish_layouts(tree, _root);
+    }
+
+    const taffy::Size<taffy::AvailableSpace> _available_space = *reinterpret_cast<const taffy::Size<taffy::AvailableSpace>*>(available_space);
+
+    async.start([self, &tree, root, _root, _available_space, on_done, user_data]()
+    {
+        const taffy_TaffyResult_of_void result = taffy_c_Taffy_compute_layout(tree, _root, _available_space);
+
+        if(result.error.type == taffy_TaffyError_Type_Ok) {
+            taffy_c_Taffy_publish_layouts(tree, _root);
+        }
+
+        tree.async.set_result(result);
+
+        if(on_done != nullptr) {
+            on_done(self, root, result, user_data);
+        }
+    });
+}
+
+taffy_TaffyResult_of_void taffy_Taffy_compute_layout_wait(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::AsyncLayout& async = reinterpret_cast<taffy_c::Taffy*>(self)->async;
+    async.wait();
+
+    return async.get_result();
+}
+
+taffy_PublishedLayouts* taffy_Taffy_acquire_layouts(const taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy_c::LayoutBuffer* buffer = reinterpret_cast<const taffy_c::Taffy*>(self)->async.acquire();
+    return reinterpret_cast<taffy_PublishedLayouts*>( const_cast<taffy_c::LayoutBuffer*>(buffer) );
+}
+
+taffy_PublishedLayouts* taffy_PublishedLayouts_retain(taffy_PublishedLayouts* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    reinterpret_cast<const taffy_c::LayoutBuffer*>(self)->retain();
+    return self;
+}
+
+void taffy_PublishedLayouts_release(taffy_PublishedLayouts* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    reinterpret_cast<const taffy_c::LayoutBuffer*>(self)->release();
+}
+
+taffy_TaffyResult_of_Layout_const_ref taffy_PublishedLayouts_layout(
+    const taffy_PublishedLayouts* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy::Layout* layout = reinterpret_cast<const taffy_c::LayoutBuffer*>(self)->find( taffy::NodeId{node.id} );
+
+    taffy_TaffyResult_of_Layout_const_ref ret;
+    ret.error.child_index = 0;
+    ret.error.child_count = 0;
+
+    if(layout == nullptr) {
+        ret.error.type = taffy_TaffyError_Type_InvalidInputNode;
+        ret.error.node = node;
+        ret.value      = nullptr;
+        return ret;
+    }
+
+    ret.error.type    = taffy_TaffyError_Type_Ok;
+    ret.error.node.id = 0;
+    ret.value         = reinterpret_cast<const taffy_Layout*>(layout);
+    return ret;
+}
+
+// -----------------------------------------------------------------------------
+// LayoutSnapshot
+
+static bool taffy_c_LayoutSnapshot_Entry_equal(const taffy_c::LayoutSnapshot::Entry& a, const taffy_c::LayoutSnapshot::Entry& b)
+{
+    if( (a.valid != b.valid) || (a.id != b.id) ) {
+        return false;
+    }
+    return !a.valid || (
+        (a.layout.order           == b.layout.order          ) &&
+        (a.layout.size.width      == b.layout.size.width     ) &&
+        (a.layout.size.height     == b.layout.size.height    ) &&
+        (a.layout.location.x      == b.layout.location.x     ) &&
+        (a.layout.location.y      == b.layout.location.y     )
+    );
+}
+
+// Fills 'snapshot' with layouts of all laid out roots (last one and other
+// ones, laid out before), taking unchanged chunks from 'previous'
+static void taffy_c_Taffy_fill_snapshot(taffy_c::Taffy& tree, const taffy_c::LayoutSnapshot* previous, taffy_c::LayoutSnapshot& snapshot)
+{
+    typedef taffy_c::LayoutSnapshot::Entry Entry;
+    typedef taffy_c::LayoutSnapshot::Chunk Chunk;
+    const size_t CHUNK_SIZE = taffy_c::LayoutSnapshot::CHUNK_SIZE;
+
+    taffy_c::Snapshots& snapshots = tree.snapshots;
+
+    std::vector<Entry>& entries = snapshots.entries;
+    for(Entry& entry : entries) {
+        entry.valid = false;
+    }
+
+    std::vector<taffy::NodeId>& walk = snapshots.walk;
+    walk.clear();
+    walk.push_back( taffy::NodeId{tree.relayout.root} );
+    for(const auto& root_space : tree.relayout.root_spaces) {
+        if(root_space.first != tree.relayout.root) {
+            walk.push_back( taffy::NodeId{root_space.first} );
+        }
+    }
+
+    while( !walk.empty() )
+    {
+        const taffy::NodeId node = walk.back();
+        walk.pop_back();
+
+        const taffy::Layout* layout = tree.layout(node);
+        if(layout == nullptr) {
+            continue;
+        }
+
+        const size_t slot = taffy_NodeId_slot(node);
+        if(slot >= entries.size()) {
+            // Whole chunks - compared with previous ones as is
+            entries.resize( (slot / CHUNK_SIZE + 1) * CHUNK_SIZE, Entry{ 0, false, taffy::Layout::with_order(0) } );
+        }
+
+        Entry& entry = entries[slot];
+        if( entry.valid && (entry.id == static_cast<uint64_t>(node)) ) {
+            continue; // root, laid out before as part of other tree
+        }
+        entry.id     = static_cast<uint64_t>(node);
+        entry.valid  = true;
+        entry.layout = *layout;
+        ++snapshot.count;
+
+        const auto children_count = tree.tree.child_count(node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(node, i);
+            if( child.is_ok() ) {
+                walk.push_back(child.value());
+            }
+        }
+    }
+
+    // NOTE: scratch is not shrunk - trailing chunks may have no valid entries
+    snapshot.chunks.resize(entries.size() / CHUNK_SIZE);
+    for(size_t i = 0; i < snapshot.chunks.size(); ++i)
+    {
+        const std::vector<Entry>::const_iterator begin = entries.begin() + static_cast<std::ptrdiff_t>(i * CHUNK_SIZE);
+
+        const bool same = (previous != nullptr) && (i < previous->chunks.size()) &&
+            std::equal(begin, begin + static_cast<std::ptrdiff_t>(CHUNK_SIZE), previous->chunks[i]->begin(), taffy_c_LayoutSnapshot_Entry_equal);
+
+        snapshot.chunks[i] = same ?
+            previous->chunks[i] :
+            std::make_shared<Chunk>(begin, begin + static_cast<std::ptrdiff_t>(CHUNK_SIZE));
+    }
+}
+
+taffy_LayoutSnapshot* taffy_Taffy_snapshot(taffy_Taffy* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.async.wait();
+
+    taffy_c::Snapshots& snapshots = tree.snapshots;
+
+    const bool changed = (snapshots.current == nullptr) ||
+        (snapshots.computations != tree.computations) ||
+        (snapshots.mutations    != tree.relayout.mutations);
+
+    if(changed)
+    {
+        taffy_c::LayoutSnapshot* snapshot = new taffy_c::LayoutSnapshot{};
+        if(tree.relayout.computed)
+        {
+            snapshot->root = tree.relayout.root;
+            taffy_c_Taffy_fill_snapshot(tree, snapshots.current, *snapshot);
+        }
+
+        snapshots.reset(); // after chunks shared
+        snapshots.current      = snapshot;
+        snapshots.computations = tree.computations;
+        snapshots.mutations    = tree.relayout.mutations;
+    }
+
+    snapshots.current->retain();
+    return reinterpret_cast<taffy_LayoutSnapshot*>(snapshots.current);
+}
+
+taffy_LayoutSnapshot* taffy_LayoutSnapshot_retain(taffy_LayoutSnapshot* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    reinterpret_cast<taffy_c::LayoutSnapshot*>(self)->retain();
+    return self;
+}
+
+void taffy_LayoutSnapshot_release(taffy_LayoutSnapshot* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    reinterpret_cast<taffy_c::LayoutSnapshot*>(self)->release();
+}
+
+taffy_NodeId taffy_LayoutSnapshot_root(const taffy_LayoutSnapshot* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    taffy_NodeId ret;
+    ret.id = reinterpret_cast<const taffy_c::LayoutSnapshot*>(self)->root;
+    return ret;
+}
+
+size_t taffy_LayoutSnapshot_nodes_count(const taffy_LayoutSnapshot* self)
+{
+    ASSERT_NOT_NULL(self);
+
+    return reinterpret_cast<const taffy_c::LayoutSnapshot*>(self)->count;
+}
+
+taffy_TaffyResult_of_Layout_const_ref taffy_LayoutSnapshot_layout(
+    const taffy_LayoutSnapshot* self,
+
+    taffy_NodeId node
+)
+{
+    ASSERT_NOT_NULL(self);
+
+    const taffy::Layout* layout = reinterpret_cast<const taffy_c::LayoutSnapshot*>(self)->find( taffy::NodeId{node.id} );
+
+    taffy_TaffyResult_of_Layout_const_ref ret;
+    ret.error.child_index = 0;
+    ret.error.child_count = 0;
+
+    if(layout == nullptr) {
+        ret.error.type = taffy_TaffyError_Type_InvalidInputNode;
+        ret.error.node = node;
+        ret.value      = nullptr;
+        return ret;
+    }
+
+    ret.error.type    = taffy_TaffyError_Type_Ok;
+    ret.error.node.id = 0;
+    ret.value         = reinterpret_cast<const taffy_Layout*>(layout);
+    return ret;
+}
+
+// -----------------------------------------------------------------------------
+// Rounding
+
+/*
+    The same as taffy 'round_layout()': location rounded, size rounded so that
+    far edge lands on rounded absolute position. 'abs_*' - unrounded absolute
+    position of node itself. std::round() rounds halfway cases away from zero.
+*/
+static void taffy_c_round_layouts_scalar(float* x, float* y, float* width, float* height, const float* abs_x, const float* abs_y, size_t count)
+{
+    for(size_t i = 0; i < count; ++i)
+    {
+        x[i]      = std::round(x[i]);
+        y[i]      = std::round(y[i]);
+        width[i]  = std::round(abs_x[i] + width[i] ) - std::round(abs_x[i]);
+        height[i] = std::round(abs_y[i] + height[i]) - std::round(abs_y[i]);
+    }
+}
+
+#if defined(TAFFY_C_ROUNDING_SSE2)
+
+// std::round() for 4 floats: truncation + 1 for fraction >= 0.5, on absolute
+// value. Values >= 2^23 (and NaN, infinity) are already integral - kept as-is.
+static inline __m128 taffy_c_round_sse2(__m128 v)
+{
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+    const __m128 sign = _mm_and_ps(v, sign_mask);
+    const __m128 a    = _mm_andnot_ps(sign_mask, v);
+
+    __m128 t = _mm_cvtepi32_ps( _mm_cvttps_epi32(a) );
+    t = _mm_add_ps(t, _mm_and_ps( _mm_cmpge_ps(_mm_sub_ps(a, t), _mm_set1_ps(0.5f)), _mm_set1_ps(1.0f) ));
+
+    const __m128 small = _mm_cmplt_ps(a, _mm_set1_ps(8388608.0f));
+    t = _mm_or_ps( _mm_and_ps(small, t), _mm_andnot_ps(small, a) );
+
+    return _mm_or_ps(t, sign);
+}
+
+static void taffy_c_round_layouts_sse2(float* x, float* y, float* width, float* height, const float* abs_x, const float* abs_y, size_t count)
+{
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        const __m128 ax = _mm_loadu_ps(abs_x + i);
+        const __m128 ay = _mm_loadu_ps(abs_y + i);
+
+        _mm_storeu_ps(x + i, taffy_c_round_sse2( _mm_loadu_ps(x + i) ));
+        _mm_storeu_ps(y + i, taffy_c_round_sse2( _mm_loadu_ps(y + i) ));
+
+        _mm_storeu_ps(width  + i, _mm_sub_ps( taffy_c_round_sse2(_mm_add_ps(ax, _mm_loadu_ps(width  + i))), taffy_c_round_sse2(ax) ));
+        _mm_storeu_ps(height + i, _mm_sub_ps( taffy_c_round_sse2(_mm_add_ps(ay, _mm_loadu_ps(height + i))), taffy_c_round_sse2(ay) ));
+    }
+
+    taffy_c_round_layouts_scalar(x + i, y + i, width + i, height + i, abs_x + i, abs_y + i, count - i);
+}
+
+#endif // TAFFY_C_ROUNDING_SSE2
+
+#if defined(TAFFY_C_ROUNDING_AVX2)
+
+// The same as 'taffy_c_round_sse2()', for 8 floats
+__attribute__((target("avx2")))
+static inline __m256 taffy_c_round_avx2(__m256 v)
+{
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+
+    const __m256 sign = _mm256_and_ps(v, sign_mask);
+    const __m256 a    = _mm256_andnot_ps(sign_mask, v);
+
+    __m256 t = _mm256_cvtepi32_ps( _mm256_cvttps_epi32(a) );
+    t = _mm256_add_ps(t, _mm256_and_ps( _mm256_cmp_ps(_mm256_sub_ps(a, t), _mm256_set1_ps(0.5f), _CMP_GE_OQ), _mm256_set1_ps(1.0f) ));
+
+    const __m256 small = _mm256_cmp_ps(a, _mm256_set1_ps(8388608.0f), _CMP_LT_OQ);
+    t = _mm256_blendv_ps(a, t, small);
+
+    return _mm256_or_ps(t, sign);
+}
+
+__attribute__((target("avx2")))
+static void taffy_c_round_layouts_avx2(float* x, float* y, float* width, float* height, const float* abs_x, const float* abs_y, size_t count)
+{
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        const __m256 ax = _mm256_loadu_ps(abs_x + i);
+        const __m256 ay = _mm256_loadu_ps(abs_y + i);
+
+        _mm256_storeu_ps(x + i, taffy_c_round_avx2( _mm256_loadu_ps(x + i) ));
+        _mm256_storeu_ps(y + i, taffy_c_round_avx2( _mm256_loadu_ps(y + i) ));
+
+        _mm256_storeu_ps(width  + i, _mm256_sub_ps( taffy_c_round_avx2(_mm256_add_ps(ax, _mm256_loadu_ps(width  + i))), taffy_c_round_avx2(ax) ));
+        _mm256_storeu_ps(height + i, _mm256_sub_ps( taffy_c_round_avx2(_mm256_add_ps(ay, _mm256_loadu_ps(height + i))), taffy_c_round_avx2(ay) ));
+    }
+
+    taffy_c_round_layouts_sse2(x + i, y + i, width + i, height + i, abs_x + i, abs_y + i, count - i);
+}
+
+#endif // TAFFY_C_ROUNDING_AVX2
+
+using taffy_c_round_layouts_func = void (*)(float*, float*, float*, float*, const float*, const float*, size_t);
+
+// Selected once, by CPU features
+static taffy_c_round_layouts_func taffy_c_round_layouts_select()
+{
+#if defined(TAFFY_C_ROUNDING_AVX2)
+    if( __builtin_cpu_supports("avx2") ) {
+        return &taffy_c_round_layouts_avx2;
+    }
+#endif
+
+#if defined(TAFFY_C_ROUNDING_SSE2)
+    return &taffy_c_round_layouts_sse2;
+#else
+    return &taffy_c_round_layouts_scalar;
+#endif
+}
+
+// Nodes in subtree of 'root', which will be laid out (dirty), before computation
+static void taffy_c_Taffy_record_dirty(taffy_c::Taffy& tree, const taffy::NodeId& root)
+{
+    taffy_c::Rounding& rounding = tree.rounding_pass;
+
+    rounding.dirty.clear();
+
+    std::vector<taffy_c::Rounding::Frame>& walk = rounding.walk;
+    walk.clear();
+    walk.push_back( taffy_c::Rounding::Frame{ root, 0.0f, 0.0f } );
+
+    while( !walk.empty() )
+    {
+        const taffy::NodeId node = walk.back().node;
+        walk.pop_back();
+
+        // NOTE: dirtiness propagated up to the root, so clean node has clean subtree
+        const auto dirty = tree.tree.dirty(node);
+        if( !dirty.is_ok() || !dirty.value() ) {
+            continue;
+        }
+        rounding.dirty.push_back( static_cast<uint64_t>(node) );
+
+        const auto children_count = tree.tree.child_count(node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(node, i);
+            if( child.is_ok() ) {
+                walk.push_back( taffy_c::Rounding::Frame{ child.value(), 0.0f, 0.0f } );
+            }
+        }
+    }
+
+    std::sort(rounding.dirty.begin(), rounding.dirty.end());
+}
+
+/*
+    Rounds layouts in subtree of 'root' into binding-side storage (taffy's own
+    layouts stay unrounded). 'root' may be an inner node (relayout boundary,
+    recomputed subtree): its absolute position accumulated from unrounded
+    locations of its ancestors, so result is the same as of whole tree
+    rounding.
+
+    In 'dirty_only' mode subtree of node is entered only if the node was
+    dirty before computation, not rounded yet, or its unrounded layout or
+    absolute position differs from ones it was rounded from: taffy lays out
+    clean node again too, if its parent gives it other constraints - then its
+    size changes. Other subtrees are the same as at previous rounding, so
+    their rounded layouts are kept.
+*/
+static void taffy_c_Taffy_round_layouts(taffy_c::Taffy& tree, const taffy::NodeId& root)
+{
+    static const taffy_c_round_layouts_func round_layouts = taffy_c_round_layouts_select();
+
+    taffy_c::Rounding& rounding = tree.rounding_pass;
+
+    rounding.nodes .clear();
+    rounding.x     .clear();
+    rounding.y     .clear();
+    rounding.width .clear();
+    rounding.height.clear();
+    rounding.abs_x .clear();
+    rounding.abs_y .clear();
+
+    // Absolute position of root's parent
+    float origin_x = 0.0f;
+    float origin_y = 0.0f;
+    for(auto parent = tree.tree.parent(root); parent.is_some(); parent = tree.tree.parent(parent.value()))
+    {
+        const auto layout = tree.tree.layout(parent.value());
+        if( layout.is_ok() ) {
+            origin_x += layout.value().get().location.x;
+            origin_y += layout.value().get().location.y;
+        }
+    }
+
+    // 1. Gather, in pre-order (absolute positions accumulated unrounded)
+    std::vector<taffy_c::Rounding::Frame>& walk = rounding.walk;
+    walk.clear();
+    walk.push_back( taffy_c::Rounding::Frame{ root, origin_x, origin_y } );
+
+    while( !walk.empty() )
+    {
+        const taffy_c::Rounding::Frame frame = walk.back();
+        walk.pop_back();
+
+        const auto layout_result = tree.tree.layout(frame.node);
+        if( !layout_result.is_ok() ) {
+            continue;
+        }
+        const taffy::Layout& layout = layout_result.value().get();
+
+        const float abs_x = frame.abs_x + layout.location.x;
+        const float abs_y = frame.abs_y + layout.location.y;
+
+        rounding.nodes .push_back(frame.node);
+        rounding.x     .push_back(layout.location.x);
+        rounding.y     .push_back(layout.location.y);
+        rounding.width .push_back(layout.size.width);
+        rounding.height.push_back(layout.size.height);
+        rounding.abs_x .push_back(abs_x);
+        rounding.abs_y .push_back(abs_y);
+
+        const bool enter = !rounding.dirty_only || (frame.node == root) ||
+            std::binary_search(rounding.dirty.begin(), rounding.dirty.end(), static_cast<uint64_t>(frame.node)) ||
+            !rounding.rounded_from(frame.node, layout, abs_x, abs_y); // changed, or not rounded yet
+        if(!enter) {
+            continue;
+        }
+
+        const auto children_count = tree.tree.child_count(frame.node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(frame.node, i);
+            if( child.is_ok() ) {
+                walk.push_back( taffy_c::Rounding::Frame{ child.value(), abs_x, abs_y } );
+            }
+        }
+    }
+
+    // 2. Round
+    round_layouts(
+        rounding.x.data(), rounding.y.data(), rounding.width.data(), rounding.height.data(),
+        rounding.abs_x.data(), rounding.abs_y.data(),
+        rounding.nodes.size()
     );
+
+    // 3. Scatter
+    for(size_t i = 0; i < rounding.nodes.size(); ++i)
+    {
+        const taffy::Layout& source = tree.tree.layout(rounding.nodes[i]).value().get();
+
+        taffy::Layout layout = source; // for 'order'
+        layout.location.x   = rounding.x[i];
+        layout.location.y   = rounding.y[i];
+        layout.size.width   = rounding.width[i];
+        layout.size.height  = rounding.height[i];
+
+        rounding.store(rounding.nodes[i], layout, source, rounding.abs_x[i], rounding.abs_y[i]); // NOTE: absolute positions not rounded in place
+    }
+
+    rounding.dirty.clear();
+}
+
+void taffy_Taffy_set_rounding_dirty_only(
+    taffy_Taffy* self,
+
+    int dirty_only
+)
+{
+    ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    reinterpret_cast<taffy_c::Taffy*>(self)->rounding_pass.dirty_only = (dirty_only != 0);
+}
+
+// -----------------------------------------------------------------------------
+// Layout changes
+
+static taffy_LayoutRect taffy_c_LayoutRect_from_cpp(const taffy::Layout& layout)
+{
+    taffy_LayoutRect rect;
+    rect.x      = layout.location.x;
+    rect.y      = layout.location.y;
+    rect.width  = layout.size.width;
+    rect.height = layout.size.height;
+    return rect;
+}
+
+static bool taffy_c_LayoutRect_equal(const taffy_LayoutRect& a, const taffy_LayoutRect& b)
+{
+    return (a.x == b.x) && (a.y == b.y) && (a.width == b.width) && (a.height == b.height);
+}
+
+/*
+    Starts tracking of computation of 'root': records nodes, dirty before it,
+    and previous layouts of nodes, not seen by tracking yet.
+
+    Subtree of 'root', seen by tracking as whole, is walked only through dirty
+    nodes (their children included - positioned by parent). Otherwise, and by
+    computation nested into not finished one (time-budgeted layout: subtrees
+    laid out by its steps are clean now) - the whole subtree.
+*/
+static void taffy_c_Taffy_track_begin(taffy_c::Taffy& tree, const taffy::NodeId& root)
+{
+    taffy_c::LayoutChanges& tracking = tree.layout_changes;
+    if( !tracking.enabled() ) {
+        return;
+    }
+
+    const bool full =
+        tracking.pending ||
+        !tracking.complete ||
+        (tracking.complete_root != static_cast<uint64_t>(root));
+
+    tracking.pending      = true;
+    tracking.pending_full = full;
+    tracking.pending_root = static_cast<uint64_t>(root);
+    tracking.pending_dirty.clear();
+
+    tracking.walk.clear();
+    tracking.walk.push_back( taffy_c::LayoutChanges::Frame{ root, 0.0f, 0.0f } );
+    while( !tracking.walk.empty() )
+    {
+        const taffy_c::LayoutChanges::Frame frame = tracking.walk.back();
+        tracking.walk.pop_back();
+
+        const taffy::Layout* layout = tree.layout(frame.node);
+        const auto source = tree.tree.layout(frame.node);
+        if( (layout == nullptr) || !source.is_ok() ) {
+            continue;
+        }
+        const taffy::Layout& s = source.value().get();
+
+        const float abs_x = frame.abs_x + s.location.x;
+        const float abs_y = frame.abs_y + s.location.y;
+
+        if(tracking.find(frame.node) == nullptr) {
+            tracking.remember(frame.node, taffy_c_LayoutRect_from_cpp(*layout), taffy_c_LayoutRect_from_cpp(s), abs_x, abs_y);
+        }
+
+        if(!full)
+        {
+            const auto dirty = tree.tree.dirty(frame.node);
+            if( !dirty.is_ok() || !dirty.value() ) {
+                continue; // seen as child of its parent
+            }
+            tracking.pending_dirty.push_back( static_cast<uint64_t>(frame.node) );
+        }
+
+        const auto children_count = tree.tree.child_count(frame.node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+        for(size_t i = 0; i < children_count.value(); ++i)
+        {
+            const auto child = tree.tree.child_at_index(frame.node, i);
+            if( child.is_ok() ) {
+                tracking.walk.push_back( taffy_c::LayoutChanges::Frame{ child.value(), abs_x, abs_y } );
+            }
+        }
+    }
+
+    std::sort(tracking.pending_dirty.begin(), tracking.pending_dirty.end());
 }
 
-taffy_Taffy* taffy_Taffy_new_with_capacity(size_t capacity)
-{
-    return reinterpret_cast<taffy_Taffy*>(
-        new taffy::Taffy{ taffy::Taffy::with_capacity(capacity) }
-    );
+/*
+    Reports nodes, which layouts differ from the last seen ones (in pre-order),
+    and stamps them with new generation.
+
+    Subtree of node is entered only if the node was dirty before computation,
+    or its layout (also unrounded one, or absolute position with rounding) is
+    changed: taffy lays out clean node again, if its parent gives it other
+    constraints - and then its size changes. Subtrees of other nodes are the
+    same as seen by tracking before.
+*/
+static void taffy_c_Taffy_track_end(taffy_c::Taffy& tree)
+{
+    taffy_c::LayoutChanges& tracking = tree.layout_changes;
+    if( !tracking.enabled() || !tracking.pending ) {
+        return;
+    }
+
+    tracking.changes.clear();
+
+    const uint64_t generation = tracking.clock + 1;
+    const taffy::NodeId root { tracking.pending_root };
+
+    tracking.walk.clear();
+    tracking.walk.push_back( taffy_c::LayoutChanges::Frame{ root, 0.0f, 0.0f } );
+    while( !tracking.walk.empty() )
+    {
+        const taffy_c::LayoutChanges::Frame frame = tracking.walk.back();
+        tracking.walk.pop_back();
+
+        const taffy::Layout* layout = tree.layout(frame.node);
+        const auto source = tree.tree.layout(frame.node);
+        if( (layout == nullptr) || !source.is_ok() ) {
+            continue; // removed
+        }
+        const taffy::Layout& s = source.value().get();
+
+        const float abs_x = frame.abs_x + s.location.x;
+        const float abs_y = frame.abs_y + s.location.y;
+
+        const taffy_LayoutRect current        = taffy_c_LayoutRect_from_cpp(*layout);
+        const taffy_LayoutRect current_source = taffy_c_LayoutRect_from_cpp(s);
+
+        const taffy_c::LayoutChanges::Known* known = tracking.find(frame.node);
+
+        const bool changed = (known != nullptr) && !taffy_c_LayoutRect_equal(known->layout, current);
+        const bool moved   = (known == nullptr) || !taffy_c_LayoutRect_equal(known->source, current_source) ||
+            ( tree.rounding && ( (known->abs_x != abs_x) || (known->abs_y != abs_y) ) );
+
+        if(changed)
+        {
+            taffy_LayoutChange change;
+            change.node.id  = static_cast<uint64_t>(frame.node);
+            change.previous = known->layout;
+            change.current  = current;
+
+            if(tracking.report) {
+                tracking.changes.push_back(change);
+            }
+            if(tracking.generations)
+            {
+                tracking.stamp(frame.node, generation);
+                tracking.clock = generation;
+            }
+        }
+
+        tracking.remember(frame.node, current, current_source, abs_x, abs_y);
+
+        const bool enter =
+            tracking.pending_full || (frame.node == root) || changed || moved ||
+            std::binary_search( tracking.pending_dirty.begin(), tracking.pending_dirty.end(), static_cast<uint64_t>(frame.node) );
+        if(!enter) {
+            continue;
+        }
+
+        const auto children_count = tree.tree.child_count(frame.node);
+        if( !children_count.is_ok() ) {
+            continue;
+        }
+
+        // Reversed - popped in order of children
+        for(size_t i = children_count.value(); i > 0; --i)
+        {
+            const auto child = tree.tree.child_at_index(frame.node, i - 1);
+            if( child.is_ok() ) {
+                tracking.walk.push_back( taffy_c::LayoutChanges::Frame{ child.value(), abs_x, abs_y } );
+            }
+        }
+    }
+
+    // Subtree of root walked as whole - next computation of it walks only
+    // changes (subtrees of other computed nodes stay seen as whole)
+    if( !tracking.complete && tracking.pending_full )
+    {
+        tracking.complete      = true;
+        tracking.complete_root = tracking.pending_root;
+    }
+
+    tracking.pending = false;
+    tracking.pending_dirty.clear();
 }
 
-void taffy_Taffy_delete(taffy_Taffy* self)
+// Abandoned computation is not reported - its laid out (and now clean)
+// subtrees are compared by walk of the whole tree next time
+static void taffy_c_Taffy_track_cancel(taffy_c::Taffy& tree)
 {
-    ASSERT_NOT_NULL(self);
+    taffy_c::LayoutChanges& tracking = tree.layout_changes;
 
-    delete reinterpret_cast<taffy::Taffy*>(self);
-    self = nullptr;
+    tracking.pending  = false;
+    tracking.complete = false;
+    tracking.pending_dirty.clear();
 }
 
-void taffy_Taffy_enable_rounding(taffy_Taffy* self)
+void taffy_Taffy_set_track_layout_changes(taffy_Taffy* self, int enabled)
 {
     ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+
+    taffy_c::LayoutChanges& tracking = reinterpret_cast<taffy_c::Taffy*>(self)->layout_changes;
 
-    reinterpret_cast<taffy::Taffy*>(self)->enable_rounding();
+    tracking.report = (enabled != 0);
+    if(!tracking.report) {
+        tracking.changes.clear();
+    }
+    if( !tracking.enabled() ) {
+        tracking.forget(); // layouts change unseen
+    }
 }
 
-void taffy_Taffy_disable_rounding(taffy_Taffy* self)
+void taffy_Taffy_set_track_layout_generations(taffy_Taffy* self, int enabled)
 {
     ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
 
-    reinterpret_cast<taffy::Taffy*>(self)->disable_rounding();
-}
+    taffy_c::LayoutChanges& tracking = reinterpret_cast<taffy_c::Taffy*>(self)->layout_changes;
 
-taffy_TaffyResult_of_NodeId taffy_Taffy_new_leaf(
-    taffy_Taffy* self,
+    tracking.generations = (enabled != 0);
+    if( !tracking.enabled() ) {
+        tracking.forget(); // layouts change unseen
+    }
+}
 
-    const taffy_Style* layout
-)
+uint64_t taffy_Taffy_layout_generation(const taffy_Taffy* self, taffy_NodeId node)
 {
     ASSERT_NOT_NULL(self);
-    ASSERT_NOT_NULL(layout);
 
-    const taffy::Style* _layout = reinterpret_cast<const taffy::Style*>(layout);
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->new_leaf(*_layout);
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+    tree.async.wait(); // stamped by computation
 
-    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    return tree.layout_changes.generation( taffy::NodeId{node.id} );
 }
 
-/* TODO: new_leaf_with_measure(...) */
-
-taffy_TaffyResult_of_NodeId taffy_Taffy_new_with_children(
-    taffy_Taffy* self,
+void taffy_Taffy_layout_generations(
+    const taffy_Taffy* self,
 
-    const taffy_Style* layout,
-    const taffy_NodeId* childs, size_t childs_count
+    const taffy_NodeId* nodes, size_t count, uint64_t* out_generations
 )
 {
     ASSERT_NOT_NULL(self);
-    ASSERT_NOT_NULL(layout);
-    if(childs_count > 0)
-    {
-        ASSERT_NOT_NULL(childs);
+    if(count > 0) {
+        ASSERT_NOT_NULL(nodes);
+        ASSERT_NOT_NULL(out_generations);
     }
 
-    const taffy::Style* _layout = reinterpret_cast<const taffy::Style*>(layout);
-    const taffy::NodeId* _childs = reinterpret_cast<const taffy::NodeId*>(childs);
-
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->new_with_children(
-        *_layout,
-        taffy::Vec<taffy::NodeId>{_childs, _childs + childs_count} // NOTE: Entire vector copy here :/
-    );
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+    tree.async.wait(); // stamped by computation
 
-    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    for(size_t i = 0; i < count; ++i) {
+        out_generations[i] = tree.layout_changes.generation( taffy::NodeId{nodes[i].id} );
+    }
 }
 
-void taffy_Taffy_clear(taffy_Taffy* self)
+taffy_LayoutChanges taffy_Taffy_changed_layouts(const taffy_Taffy* self)
 {
     ASSERT_NOT_NULL(self);
 
-    reinterpret_cast<taffy::Taffy*>(self)->clear();
-}
+    const taffy_c::Taffy& tree = *reinterpret_cast<const taffy_c::Taffy*>(self);
+    tree.async.wait(); // reported by computation
 
-taffy_TaffyResult_of_NodeId taffy_Taffy_remove(
-    taffy_Taffy* self,
+    const taffy_c::LayoutChanges& tracking = tree.layout_changes;
 
-    taffy_NodeId node
-)
+    taffy_LayoutChanges ret;
+    ret.items       = tracking.changes.data();
+    ret.items_count = tracking.changes.size();
+    return ret;
+}
+
+static float taffy_c_LayoutRect_area(const taffy_LayoutRect& r)
 {
-    ASSERT_NOT_NULL(self);
+    return r.width * r.height;
+}
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->remove(
-        taffy::NodeId{node.id}
-    );
+static taffy_LayoutRect taffy_c_LayoutRect_union(const taffy_LayoutRect& a, const taffy_LayoutRect& b)
+{
+    const float left   = std::min(a.x, b.x);
+    const float top    = std::min(a.y, b.y);
+    const float right  = std::max(a.x + a.width,  b.x + b.width );
+    const float bottom = std::max(a.y + a.height, b.y + b.height);
 
-    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    taffy_LayoutRect ret;
+    ret.x      = left;
+    ret.y      = top;
+    ret.width  = right  - left;
+    ret.height = bottom - top;
+    return ret;
 }
 
-/* TODO: set_measure(...) */
+// Area, covered by union, but not by 'a' or 'b' (<= 0 - nothing to lose by merge)
+static float taffy_c_LayoutRect_merge_cost(const taffy_LayoutRect& a, const taffy_LayoutRect& b)
+{
+    const float overlap_w = std::min(a.x + a.width,  b.x + b.width ) - std::max(a.x, b.x);
+    const float overlap_h = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+    const float overlap   = ( (overlap_w > 0.0f) && (overlap_h > 0.0f) ) ? (overlap_w * overlap_h) : 0.0f;
 
-taffy_TaffyResult_of_void taffy_Taffy_add_child(
-    taffy_Taffy* self,
+    return taffy_c_LayoutRect_area(taffy_c_LayoutRect_union(a, b)) - (taffy_c_LayoutRect_area(a) + taffy_c_LayoutRect_area(b) - overlap);
+}
 
-    taffy_NodeId parent, taffy_NodeId child
-)
+// Merges rects (in place) to at most 'max_rects', returns their count
+static size_t taffy_c_LayoutRect_merge(std::vector<taffy_LayoutRect>& rects, size_t max_rects)
 {
-    ASSERT_NOT_NULL(self);
+    // Greedy search is O(n^3) in rects count - bounded by this constant
+    static constexpr size_t GREEDY_LIMIT = 64;
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->add_child(
-        taffy::NodeId{parent.id}, taffy::NodeId{child.id}
-    );
+    // 1. Too many rects for greedy search: merge neighbours (in rows order)
+    //    pairwise, until count is reasonable (8 per requested rect, but not
+    //    above greedy limit - or just 'max_rects', if it is above it)
+    const size_t pairwise_limit = std::max( max_rects, (max_rects < GREEDY_LIMIT / 8) ? (max_rects * 8) : GREEDY_LIMIT );
+    if(rects.size() > pairwise_limit)
+    {
+        std::sort(rects.begin(), rects.end(), [](const taffy_LayoutRect& a, const taffy_LayoutRect& b) {
+            return (a.y < b.y) || ( (a.y == b.y) && (a.x < b.x) );
+        });
 
-    return taffy_TaffyResult_of_void_from_cpp(result);
-}
+        while(rects.size() > pairwise_limit)
+        {
+            size_t count = 0;
+            for(size_t i = 0; i < rects.size(); i += 2)
+            {
+                rects[count++] = (i + 1 < rects.size()) ? taffy_c_LayoutRect_union(rects[i], rects[i + 1]) : rects[i];
+            }
+            rects.resize(count);
+        }
+    }
 
-taffy_TaffyResult_of_void taffy_Taffy_insert_child_at_index(
-    taffy_Taffy* self,
+    // Already at most 'max_rects' - merges without added area skipped
+    if(rects.size() > GREEDY_LIMIT) {
+        return rects.size();
+    }
 
-    taffy_NodeId parent, size_t child_index, taffy_NodeId child
-)
-{
-    ASSERT_NOT_NULL(self);
+    // 2. Greedy: the cheapest pair merged, while too many rects or merge
+    //    loses nothing
+    while(rects.size() > 1)
+    {
+        size_t best_a    = 0;
+        size_t best_b    = 1;
+        float  best_cost = taffy_c_LayoutRect_merge_cost(rects[0], rects[1]);
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->insert_child_at_index(
-        taffy::NodeId{parent.id}, child_index, taffy::NodeId{child.id}
-    );
+        for(size_t a = 0; a < rects.size(); ++a)
+        {
+            for(size_t b = a + 1; b < rects.size(); ++b)
+            {
+                const float cost = taffy_c_LayoutRect_merge_cost(rects[a], rects[b]);
+                if(cost < best_cost)
+                {
+                    best_a    = a;
+                    best_b    = b;
+                    best_cost = cost;
+                }
+            }
+        }
 
-    return taffy_TaffyResult_of_void_from_cpp(result);
+        if( (rects.size() <= max_rects) && (best_cost > 0.0f) ) {
+            break;
+        }
+
+        rects[best_a] = taffy_c_LayoutRect_union(rects[best_a], rects[best_b]);
+        rects[best_b] = rects.back();
+        rects.pop_back();
+    }
+
+    return rects.size();
 }
 
-taffy_TaffyResult_of_void taffy_Taffy_set_children(
+size_t taffy_Taffy_damage_rects(
     taffy_Taffy* self,
 
-    taffy_NodeId parent, const taffy_NodeId* childs, size_t childs_count
+    taffy_NodeId root, taffy_LayoutRect* out_rects, size_t max_rects
 )
 {
     ASSERT_NOT_NULL(self);
-    if(childs_count > 0) {
-        ASSERT_NOT_NULL(childs);
+
+    if(max_rects == 0) {
+        return 0;
     }
+    ASSERT_NOT_NULL(out_rects);
 
-    const taffy::NodeId* _childs = reinterpret_cast<const taffy::NodeId*>(childs);
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.async.wait(); // reported by computation
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->set_children(
-        taffy::NodeId{parent.id},
-        taffy::Vec<taffy::NodeId>{_childs, _childs + childs_count} // NOTE: Entire vector copy here :/
-    );
+    taffy_c::LayoutChanges& tracking = tree.layout_changes;
 
-    return taffy_TaffyResult_of_void_from_cpp(result);
-}
+    const taffy::NodeId _root { root.id };
 
-taffy_TaffyResult_of_NodeId taffy_Taffy_remove_child(
-    taffy_Taffy* self,
+    tracking.changes_index.clear();
+    for(size_t i = 0; i < tracking.changes.size(); ++i) {
+        tracking.changes_index.emplace(tracking.changes[i].node.id, i);
+    }
 
-    taffy_NodeId parent, taffy_NodeId child
-)
-{
-    ASSERT_NOT_NULL(self);
+    // Absolute rects: sum of ancestors locations - previous ones for changed
+    // ancestors, current ones for the rest
+    tracking.rects.clear();
+    for(const taffy_LayoutChange& change : tracking.changes)
+    {
+        float previous_x = change.previous.x;
+        float previous_y = change.previous.y;
+        float current_x  = change.current .x;
+        float current_y  = change.current .y;
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->remove_child(
-        taffy::NodeId{parent.id}, taffy::NodeId{child.id}
-    );
+        taffy::NodeId node { change.node.id };
 
-    return taffy_TaffyResult_of_NodeId_from_cpp(result);
-}
+        bool in_root = (node == _root);
+        while(!in_root)
+        {
+            const auto parent = tree.tree.parent(node);
+            if( parent.is_none() ) {
+                break;
+            }
+            node = parent.value();
 
-taffy_TaffyResult_of_NodeId taffy_Taffy_remove_child_at_index(
-    taffy_Taffy* self,
+            const taffy::Layout* layout = tree.layout(node);
+            if(layout == nullptr) {
+                break;
+            }
+            const taffy::Layout& l = *layout;
 
-    taffy_NodeId parent, size_t child_index
-)
-{
-    ASSERT_NOT_NULL(self);
+            const auto found = tracking.changes_index.find( static_cast<uint64_t>(node) );
+            const taffy_LayoutRect& previous = (found != tracking.changes_index.end()) ?
+                tracking.changes[found->second].previous : taffy_c_LayoutRect_from_cpp(l);
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->remove_child_at_index(
-        taffy::NodeId{parent.id}, child_index
-    );
+            previous_x += previous.x;
+            previous_y += previous.y;
+            current_x  += l.location.x;
+            current_y  += l.location.y;
 
-    return taffy_TaffyResult_of_NodeId_from_cpp(result);
-}
+            in_root = (node == _root);
+        }
+        if(!in_root) {
+            continue; // not in subtree of 'root'
+        }
 
-taffy_TaffyResult_of_NodeId replace_child_at_index(
-    taffy_Taffy* self,
+        taffy_LayoutRect previous = change.previous;
+        previous.x = previous_x;
+        previous.y = previous_y;
 
-    taffy_NodeId parent, size_t child_index, taffy_NodeId child
-)
-{
-    ASSERT_NOT_NULL(self);
+        taffy_LayoutRect current = change.current;
+        current.x = current_x;
+        current.y = current_y;
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->replace_child_at_index(
-        taffy::NodeId{parent.id}, child_index, taffy::NodeId{child.id}
-    );
+        if(taffy_c_LayoutRect_area(previous) > 0.0f) {
+            tracking.rects.push_back(previous);
+        }
+        if(taffy_c_LayoutRect_area(current) > 0.0f) {
+            tracking.rects.push_back(current);
+        }
+    }
 
-    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    const size_t count = taffy_c_LayoutRect_merge(tracking.rects, max_rects);
+    std::copy(tracking.rects.begin(), tracking.rects.begin() + count, out_rects);
+
+    return count;
 }
 
-taffy_TaffyResult_of_NodeId taffy_Taffy_child_at_index(
-    const taffy_Taffy* self,
+// -----------------------------------------------------------------------------
+// Virtual list
 
-    taffy_NodeId parent, size_t child_index
-)
+static taffy::Style taffy_c_VirtualList_spacer_style(taffy_c::VirtualList& list)
 {
-    ASSERT_NOT_NULL(self);
-
-    const auto result = reinterpret_cast<const taffy::Taffy*>(self)->child_at_index(
-        taffy::NodeId{parent.id}, child_index
-    );
-
-    return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    taffy::Style style = taffy::Style::DEFAULT();
+    style.size = taffy::Size<taffy::Dimension>{
+        taffy::Dimension::Length(0.0f),
+        taffy::Dimension::Length( static_cast<float>(list.total()) )
+    };
+    style.flex_shrink = 0.0f;
+    return style;
 }
 
-taffy_TaffyResult_of_size_t taffy_Taffy_child_count(
-    const taffy_Taffy* self,
-
-    taffy_NodeId parent
-)
+static void taffy_c_Taffy_update_spacer(taffy_c::Taffy& tree, taffy_c::VirtualList& list)
 {
-    ASSERT_NOT_NULL(self);
+    const taffy::NodeId spacer { list.spacer };
 
-    const auto result = reinterpret_cast<const taffy::Taffy*>(self)->child_count(
-        taffy::NodeId{parent.id}
-    );
+    const auto current = tree.tree.style(spacer);
+    if( !current.is_ok() ) {
+        return; // NOTE: spacer owned by list, not removed separately
+    }
 
-    return taffy_TaffyResult_of_size_t_from_cpp(result);
+    const taffy::Style style = taffy_c_VirtualList_spacer_style(list);
+    if( current.value().get() != style )
+    {
+        tree.tree.set_style(spacer, style);
+        tree.changed(spacer);
+    }
 }
 
-taffy_TaffyResult_of_Vec_of_NodeId taffy_Taffy_children(
-    const taffy_Taffy* self,
-
-    taffy_NodeId parent
-)
+// List data, or null if 'node' is not virtual list
+static taffy_c::VirtualList* taffy_c_Taffy_virtual_list(taffy_c::Taffy& tree, const taffy::NodeId& node)
 {
-    ASSERT_NOT_NULL(self);
-
-    const auto result = reinterpret_cast<const taffy::Taffy*>(self)->Children(
-        taffy::NodeId{parent.id}
-    );
-
-    return taffy_TaffyResult_of_Vec_of_NodeId_from_cpp(result);
+    taffy_c::NodeData* data = tree.find_mut(node);
+    return (data != nullptr) ? data->virtual_list.get() : nullptr;
 }
 
-taffy_TaffyResult_of_void taffy_Taffy_set_style(
+taffy_TaffyResult_of_NodeId taffy_Taffy_new_virtual_list(
     taffy_Taffy* self,
 
-    taffy_NodeId node, const taffy_Style* style
+    const taffy_Style* style,
+    size_t rows_count, float row_size, taffy_RowSizeFunc row_size_func, void* user_data
 )
 {
     ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
     ASSERT_NOT_NULL(style);
 
-    const taffy::Style* _style = reinterpret_cast<const taffy::Style*>(style);
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->set_style(
-        taffy::NodeId{node.id}, *_style
+    std::unique_ptr<taffy_c::VirtualList> list { new taffy_c::VirtualList{} };
+    list->set_rows(rows_count, row_size, row_size_func, user_data);
+
+    const auto spacer = tree.tree.new_leaf( taffy_c_VirtualList_spacer_style(*list) );
+    if( !spacer.is_ok() ) {
+        return taffy_TaffyResult_of_NodeId_from_cpp(spacer);
+    }
+
+    const auto result = tree.tree.new_with_children(
+        *reinterpret_cast<const taffy::Style*>(style),
+        taffy::Vec<taffy::NodeId>{ spacer.value() }
     );
+    if( !result.is_ok() ) {
+        tree.tree.remove(spacer.value());
+        return taffy_TaffyResult_of_NodeId_from_cpp(result);
+    }
 
-    return taffy_TaffyResult_of_void_from_cpp(result);
+    list->spacer = static_cast<uint64_t>(spacer.value());
+    tree.data(result.value()).virtual_list = std::move(list);
+    tree.place_child(spacer.value(), 0);
+
+    return taffy_TaffyResult_of_NodeId_make_ok(result.value());
 }
 
-taffy_TaffyResult_of_Style_const_ref taffy_Taffy_style(
-    const taffy_Taffy* self,
+taffy_TaffyResult_of_void taffy_Taffy_virtual_list_set_rows(
+    taffy_Taffy* self,
 
-    taffy_NodeId node
+    taffy_NodeId node,
+    size_t rows_count, float row_size, taffy_RowSizeFunc row_size_func, void* user_data
 )
 {
     ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
 
-    const auto result = reinterpret_cast<const taffy::Taffy*>(self)->style(
-        taffy::NodeId{node.id}
-    );
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
 
-    return taffy_TaffyResult_of_Style_const_ref_from_cpp(result);
+    taffy_c::VirtualList* list = taffy_c_Taffy_virtual_list(tree, taffy::NodeId{node.id});
+    if(list == nullptr) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    list->set_rows(rows_count, row_size, row_size_func, user_data);
+    taffy_c_Taffy_update_spacer(tree, *list);
+
+    return taffy_TaffyResult_of_void_make_ok();
 }
 
-taffy_TaffyResult_of_Layout_const_ref taffy_Taffy_layout(
-    const taffy_Taffy* self,
+taffy_TaffyResult_of_void taffy_Taffy_virtual_list_invalidate_rows(
+    taffy_Taffy* self,
 
-    taffy_NodeId node
+    taffy_NodeId node, size_t first_row, size_t rows_count
 )
 {
     ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
 
-    const auto result = reinterpret_cast<const taffy::Taffy*>(self)->layout(
-        taffy::NodeId{node.id}
-    );
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
 
-    return taffy_TaffyResult_of_Layout_const_ref_from_cpp(result);
+    taffy_c::VirtualList* list = taffy_c_Taffy_virtual_list(tree, taffy::NodeId{node.id});
+    if(list == nullptr) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
+
+    list->invalidate(first_row, rows_count);
+    taffy_c_Taffy_update_spacer(tree, *list);
+
+    return taffy_TaffyResult_of_void_make_ok();
 }
 
-taffy_TaffyResult_of_void taffy_Taffy_mark_dirty(
+taffy_TaffyResult_of_void taffy_Taffy_virtual_list_set_window(
     taffy_Taffy* self,
 
-    taffy_NodeId node
+    taffy_NodeId node,
+    size_t first_row, const taffy_NodeId* rows, size_t rows_count
 )
 {
     ASSERT_NOT_NULL(self);
+    taffy_c_Taffy_wait_async(self);
+    if(rows_count > 0) {
+        ASSERT_NOT_NULL(rows);
+    }
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->mark_dirty(
-        taffy::NodeId{node.id}
-    );
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
 
-    return taffy_TaffyResult_of_void_from_cpp(result);
-}
+    const taffy::NodeId _node { node.id };
 
-taffy_TaffyResult_of_bool taffy_Taffy_dirty(
-    const taffy_Taffy* self,
+    taffy_c::VirtualList* list = taffy_c_Taffy_virtual_list(tree, _node);
+    if(list == nullptr) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidInputNode, 0, 0);
+        ret.error.node = node;
+        return ret;
+    }
 
-    taffy_NodeId node
-)
-{
-    ASSERT_NOT_NULL(self);
+    if( (first_row > list->rows_count) || (rows_count > (list->rows_count - first_row)) ) {
+        taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_ChildIndexOutOfBounds, first_row + rows_count, list->rows_count);
+        ret.error.node = node;
+        return ret;
+    }
 
-    const auto result = reinterpret_cast<const taffy::Taffy*>(self)->dirty(
-        taffy::NodeId{node.id}
-    );
+    for(size_t i = 0; i < rows_count; ++i)
+    {
+        if( !tree.contains( taffy::NodeId{rows[i].id} ) ) {
+            taffy_TaffyResult_of_void ret = taffy_TaffyResult_of_void_make_error(taffy_TaffyError_Type_InvalidChildNode, 0, 0);
+            ret.error.node = rows[i];
+            return ret;
+        }
+    }
+
+    taffy_c_Taffy_update_spacer(tree, *list);
+
+    // Rows are absolutely positioned at their offsets - so they not affect
+    // content size (spacer does) and each other
+    for(size_t i = 0; i < rows_count; ++i)
+    {
+        const taffy::NodeId row { rows[i].id };
+        const size_t        index = first_row + i;
+
+        const auto current = tree.tree.style(row);
+        if( !current.is_ok() ) {
+            return taffy_TaffyResult_of_void_from_cpp_error(current.error()); // checked above
+        }
+
+        taffy::Style style = current.value().get();
+        style.position     = taffy::Position::Absolute();
+        style.inset.left   = taffy::LengthPercentageAuto::Length(0.0f);
+        style.inset.right  = taffy::LengthPercentageAuto::Length(0.0f);
+        style.inset.top    = taffy::LengthPercentageAuto::Length( static_cast<float>(list->offset(index)) );
+        style.inset.bottom = taffy::LengthPercentageAuto::Auto();
+        style.size.height  = taffy::Dimension::Length( list->size(index) );
+
+        if( current.value().get() != style )
+        {
+            tree.tree.set_style(row, style);
+            tree.changed(row);
+        }
+    }
+
+    // Children: spacer + window rows. Not changed - not set, to keep it clean
+    const auto children_count = tree.tree.child_count(_node);
+    bool same = children_count.is_ok() && (children_count.value() == rows_count + 1);
+    for(size_t i = 0; same && (i < rows_count); ++i)
+    {
+        const auto child = tree.tree.child_at_index(_node, i + 1);
+        same = child.is_ok() && (static_cast<uint64_t>(child.value()) == rows[i].id);
+    }
 
-    return taffy_TaffyResult_of_bool_from_cpp(result);
+    if(!same)
+    {
+        taffy::Vec<taffy::NodeId> children;
+        children.reserve(rows_count + 1);
+        children.push_back( taffy::NodeId{list->spacer} );
+        for(size_t i = 0; i < rows_count; ++i) {
+            children.push_back( taffy::NodeId{rows[i].id} );
+        }
+
+        const auto result = tree.tree.set_children(_node, children);
+        if( !result.is_ok() ) {
+            return taffy_TaffyResult_of_void_from_cpp(result);
+        }
+        tree.content_changed(_node);
+        tree.reindex_children(_node, 0);
+    }
+
+    return taffy_TaffyResult_of_void_make_ok();
 }
 
-taffy_TaffyResult_of_void taffy_Taffy_compute_layout(
+taffy_TaffyResult_of_size_t taffy_Taffy_virtual_list_row_at(
     taffy_Taffy* self,
 
-    taffy_NodeId node, const taffy_Size_of_AvailableSpace* available_space
+    taffy_NodeId node, float offset
 )
 {
     ASSERT_NOT_NULL(self);
-    ASSERT_NOT_NULL(available_space);
 
-    const taffy::Size<taffy::AvailableSpace>* _available_space = reinterpret_cast<const taffy::Size<taffy::AvailableSpace>*>(available_space);
+    taffy_c::Taffy& tree = *reinterpret_cast<taffy_c::Taffy*>(self);
+    tree.async.wait(); // sizes rebuilt from measured rows
 
-    const auto result = reinterpret_cast<taffy::Taffy*>(self)->compute_layout(
-        taffy::NodeId{node.id}, *_available_space
-    );
+    taffy_TaffyResult_of_size_t ret;
+    ret.error.type        = taffy_TaffyError_Type_Ok;
+    ret.error.node.id     = 0;
+    ret.error.child_index = 0;
+    ret.error.child_count = 0;
+    ret.value = 0;
+
+    taffy_c::VirtualList* list = taffy_c_Taffy_virtual_list(tree, taffy::NodeId{node.id});
+    if(list == nullptr) {
+        ret.error.type = taffy_TaffyError_Type_InvalidInputNode;
+        ret.error.node = node;
+        return ret;
+    }
 
-    return taffy_TaffyResult_of_void_from_cpp(result);
+    ret.value = list->row_at( static_cast<double>(offset) );
+    return ret;
 }
@@ -0,0 +1,2032 @@
+/*
+    Behavioural tests of 'taffy_cpp_c' binding-side features (reconciler,
+    incremental and parallel layout, etc). Each check compares results of
+    the feature with the plain way to get the same results.
+*/
+
+#include <stdio.h>  /* fprintf(), printf() */
+#include <stdlib.h> /* EXIT_SUCCESS, EXIT_FAILURE */
+
+#include <taffy_cpp_c.h>
+
+/* -------------------------------------------------------------------------- */
+
+static int failures_count = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if( !(condition) ) {                                                    \
+            ++failures_count;                                                   \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        }                                                                       \
+    } while(0)
+
+#define CHECK_OK(result) CHECK( (result).error.type == taffy_TaffyError_Type_Ok )
+
+/* Helpers ------------------------------------------------------------------ */
+
+#define AUTO (-1.0f)
+
+static taffy_Dimension* make_dimension(float value) /* < 0 - auto */
+{
+    return (value >= 0.0f) ? taffy_Dimension_new_Length(value) : taffy_Dimension_new_Auto();
+}
+
+static void set_size(taffy_Style* style, float width, float height)
+{
+    taffy_Dimension* w = make_dimension(width);
+    taffy_Dimension* h = make_dimension(height);
+    taffy_Size_of_Dimension* size = taffy_Size_of_Dimension_new(w, h);
+
+    taffy_Style_set_size(style, size);
+
+    taffy_Size_of_Dimension_delete(size);
+    taffy_Dimension_delete(h);
+    taffy_Dimension_delete(w);
+}
+
+static taffy_Style* make_style(float width, float height)
+{
+    taffy_Style* style = taffy_Style_new_default();
+    set_size(style, width, height);
+    return style;
+}
+
+static taffy_Size_of_AvailableSpace* make_space(float width, float height)
+{
+    taffy_AvailableSpace* w = taffy_AvailableSpace_new_Definite(width);
+    taffy_AvailableSpace* h = taffy_AvailableSpace_new_Definite(height);
+    taffy_Size_of_AvailableSpace* space = taffy_taffy_Size_of_AvailableSpace_new(w, h);
+
+    taffy_AvailableSpace_delete(h);
+    taffy_AvailableSpace_delete(w);
+    return space;
+}
+
+static taffy_NodeId new_leaf(taffy_Taffy* tree, float width, float height)
+{
+    taffy_Style* style = make_style(width, height);
+    const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_leaf(tree, style);
+    taffy_Style_delete(style);
+
+    CHECK_OK(result);
+    return result.value;
+}
+
+static taffy_NodeId new_node(taffy_Taffy* tree, float width, float height, const taffy_NodeId* children, size_t children_count)
+{
+    taffy_Style* style = make_style(width, height);
+    const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_with_children(tree, style, children, children_count);
+    taffy_Style_delete(style);
+
+    CHECK_OK(result);
+    return result.value;
+}
+
+static void compute(taffy_Taffy* tree, taffy_NodeId root, float width, float height)
+{
+    taffy_Size_of_AvailableSpace* space = make_space(width, height);
+    CHECK_OK( taffy_Taffy_compute_layout(tree, root, space) );
+    taffy_Size_of_AvailableSpace_delete(space);
+}
+
+typedef struct {
+    float x;
+    float y;
+    float width;
+    float height;
+} Rect;
+
+static Rect rect_of(taffy_TaffyResult_of_Layout_const_ref result)
+{
+    Rect rect = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    CHECK_OK(result);
+    if(result.error.type == taffy_TaffyError_Type_Ok)
+    {
+        rect.x      = taffy_Point_of_float_get_x     ( taffy_Layout_get_location(result.value) );
+        rect.y      = taffy_Point_of_float_get_y     ( taffy_Layout_get_location(result.value) );
+        rect.width  = taffy_Size_of_float_get_width  ( taffy_Layout_get_size    (result.value) );
+        rect.height = taffy_Size_of_float_get_height ( taffy_Layout_get_size    (result.value) );
+    }
+    return rect;
+}
+
+static Rect layout_of(const taffy_Taffy* tree, taffy_NodeId node)
+{
+    return rect_of( taffy_Taffy_layout(tree, node) );
+}
+
+static int rect_eq(Rect a, Rect b)
+{
+    return (a.x == b.x) && (a.y == b.y) && (a.width == b.width) && (a.height == b.height);
+}
+
+static int is_dirty(const taffy_Taffy* tree, taffy_NodeId node)
+{
+    const taffy_TaffyResult_of_bool result = taffy_Taffy_dirty(tree, node);
+    CHECK_OK(result);
+    return result.value;
+}
+
+static size_t child_count(const taffy_Taffy* tree, taffy_NodeId node)
+{
+    const taffy_TaffyResult_of_size_t result = taffy_Taffy_child_count(tree, node);
+    CHECK_OK(result);
+    return result.value;
+}
+
+/* Scene: root (row) -> [ head, panel (fixed size) -> [ a, b ], tail ] */
+
+typedef struct {
+    taffy_NodeId root;
+    taffy_NodeId head;
+    taffy_NodeId panel;
+    taffy_NodeId a;
+    taffy_NodeId b;
+    taffy_NodeId tail;
+} Scene;
+
+static Scene build_scene(taffy_Taffy* tree, float a_width)
+{
+    Scene scene;
+    taffy_NodeId items[3];
+
+    taffy_Style* panel_style = make_style(60.0f, 60.0f);
+    taffy_Style_set_flex_shrink(panel_style, 0.0f); /* not flexed by parent */
+
+    scene.head = new_leaf(tree, 30.4f, 30.0f);
+    scene.a    = new_leaf(tree, a_width, 10.0f);
+    scene.b    = new_leaf(tree, 10.0f, 10.3f);
+    scene.tail = new_leaf(tree, 20.0f, 20.0f);
+
+    items[0] = scene.a;
+    items[1] = scene.b;
+    {
+        const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_with_children(tree, panel_style, items, 2);
+        CHECK_OK(result);
+        scene.panel = result.value;
+    }
+
+    items[0] = scene.head;
+    items[1] = scene.panel;
+    items[2] = scene.tail;
+    scene.root = new_node(tree, AUTO, AUTO, items, 3);
+
+    taffy_Style_delete(panel_style);
+    return scene;
+}
+
+static int scene_eq(const taffy_Taffy* tree1, Scene s1, const taffy_Taffy* tree2, Scene s2)
+{
+    return
+        rect_eq( layout_of(tree1, s1.root ), layout_of(tree2, s2.root ) ) &&
+        rect_eq( layout_of(tree1, s1.head ), layout_of(tree2, s2.head ) ) &&
+        rect_eq( layout_of(tree1, s1.panel), layout_of(tree2, s2.panel) ) &&
+        rect_eq( layout_of(tree1, s1.a    ), layout_of(tree2, s2.a    ) ) &&
+        rect_eq( layout_of(tree1, s1.b    ), layout_of(tree2, s2.b    ) ) &&
+        rect_eq( layout_of(tree1, s1.tail ), layout_of(tree2, s2.tail ) );
+}
+
+static void set_leaf_size(taffy_Taffy* tree, taffy_NodeId node, float width, float height)
+{
+    taffy_Style* style = make_style(width, height);
+    CHECK_OK( taffy_Taffy_set_style(tree, node, style) );
+    taffy_Style_delete(style);
+}
+
+/* Siblings: root (row, fixed width) -> [ text, box (flex grow) -> [ c1, c2 ] ].
+   Growing 'text' shrinks clean 'box' - taffy lays out its children again. */
+
+typedef struct {
+    taffy_NodeId root;
+    taffy_NodeId text;
+    taffy_NodeId box;
+    taffy_NodeId c1;
+    taffy_NodeId c2;
+} Siblings;
+
+static taffy_NodeId new_growing(taffy_Taffy* tree, float height, const taffy_NodeId* children, size_t children_count)
+{
+    taffy_Style* style = make_style(AUTO, height);
+    taffy_TaffyResult_of_NodeId result;
+
+    taffy_Style_set_flex_grow(style, 1.0f);
+    result = taffy_Taffy_new_with_children(tree, style, children, children_count);
+    taffy_Style_delete(style);
+
+    CHECK_OK(result);
+    return result.value;
+}
+
+static Siblings build_siblings(taffy_Taffy* tree, float text_width)
+{
+    Siblings siblings;
+    taffy_NodeId items[2];
+
+    siblings.text = new_leaf(tree, text_width, 10.0f);
+    siblings.c1   = new_growing(tree, 10.0f, NULL, 0);
+    siblings.c2   = new_growing(tree, 10.0f, NULL, 0);
+
+    items[0] = siblings.c1;
+    items[1] = siblings.c2;
+    siblings.box = new_growing(tree, AUTO, items, 2);
+
+    items[0] = siblings.text;
+    items[1] = siblings.box;
+    siblings.root = new_node(tree, 100.3f, 50.0f, items, 2);
+
+    return siblings;
+}
+
+static int siblings_eq(const taffy_Taffy* tree1, Siblings s1, const taffy_Taffy* tree2, Siblings s2)
+{
+    return
+        rect_eq( layout_of(tree1, s1.root), layout_of(tree2, s2.root) ) &&
+        rect_eq( layout_of(tree1, s1.text), layout_of(tree2, s2.text) ) &&
+        rect_eq( layout_of(tree1, s1.box ), layout_of(tree2, s2.box ) ) &&
+        rect_eq( layout_of(tree1, s1.c1  ), layout_of(tree2, s2.c1  ) ) &&
+        rect_eq( layout_of(tree1, s1.c2  ), layout_of(tree2, s2.c2  ) );
+}
+
+/* Measure functions -------------------------------------------------------- */
+
+#define TEXT_GLYPHS      10
+#define TEXT_ADVANCE     2.0f
+#define TEXT_LINE_HEIGHT 5.0f
+#define TEXT_BOX_WIDTH   7.0f /* 3 glyphs per line */
+
+typedef struct {
+    size_t calls;
+} MeasureCalls;
+
+/* The same as built-in glyph wrap of 'TEXT_GLYPHS' glyphs */
+static taffy_MeasureSize glyphs_size(taffy_MeasureKnownDimensions known_dimensions, taffy_MeasureAvailableSpace available_space)
+{
+    const float max_width = (float)TEXT_GLYPHS * TEXT_ADVANCE;
+
+    size_t limit = TEXT_GLYPHS, per_line;
+    taffy_MeasureSize size;
+
+    if( known_dimensions.width_is_some || (available_space.width_type == taffy_AvailableSpace_Type_Definite) )
+    {
+        const float width = known_dimensions.width_is_some ? known_dimensions.width : available_space.width;
+        if(width < max_width) {
+            limit = (width > 0.0f) ? (size_t)(width / TEXT_ADVANCE + 1e-4f) : 0;
+        }
+    }
+    else if(available_space.width_type == taffy_AvailableSpace_Type_MinContent)
+    {
+        limit = 0;
+    }
+    per_line = (limit > 0) ? limit : 1;
+
+    size.width  = known_dimensions.width_is_some  ? known_dimensions.width  : (float)per_line * TEXT_ADVANCE;
+    size.height = known_dimensions.height_is_some ? known_dimensions.height : (float)((TEXT_GLYPHS + per_line - 1) / per_line) * TEXT_LINE_HEIGHT;
+    return size;
+}
+
+static taffy_MeasureSize measure_glyphs(taffy_MeasureKnownDimensions known_dimensions, taffy_MeasureAvailableSpace available_space, void* user_data)
+{
+    ++((MeasureCalls*)user_data)->calls;
+    return glyphs_size(known_dimensions, available_space);
+}
+
+static void batch_measure_glyphs(const taffy_MeasureRequest* requests, size_t requests_count, taffy_MeasureSize* results, void* user_data)
+{
+    size_t i;
+
+    ++((MeasureCalls*)user_data)->calls;
+    for(i = 0; i < requests_count; ++i) {
+        results[i] = glyphs_size(requests[i].known_dimensions, requests[i].available_space);
+    }
+}
+
+typedef enum {
+    TEXTS_FIXED_SIZE, /* leaves of expected sizes */
+    TEXTS_FIXED_TEXT, /* built-in measure */
+    TEXTS_MEASURED    /* glyph wrapped text - by 'measure_glyphs()', others - built-in */
+} TextsKind;
+
+/* root (column, 'TEXT_BOX_WIDTH' wide) -> [ glyph wrapped, word wrapped, single line ] */
+typedef struct {
+    taffy_NodeId root;
+    taffy_NodeId glyph;
+    taffy_NodeId word;
+    taffy_NodeId line;
+} Texts;
+
+static taffy_NodeId new_text(taffy_Taffy* tree, taffy_FixedText_Wrap wrap)
+{
+    /* unsorted, duplicated and out of range breaks: words of 4, 3 and 3 glyphs */
+    static const size_t breaks[] = { 7, 4, 4, 0, 12 };
+
+    taffy_Style* style = taffy_Style_new_default();
+    taffy_FixedText text;
+    taffy_TaffyResult_of_NodeId result;
+
+    text.glyph_count         = TEXT_GLYPHS;
+    text.advance             = TEXT_ADVANCE;
+    text.line_height         = TEXT_LINE_HEIGHT;
+    text.wrap                = wrap;
+    text.break_offsets       = breaks;
+    text.break_offsets_count = sizeof(breaks) / sizeof(breaks[0]);
+
+    result = taffy_Taffy_new_leaf_with_fixed_text(tree, style, &text);
+    taffy_Style_delete(style);
+
+    CHECK_OK(result);
+    return result.value;
+}
+
+static Texts build_texts(taffy_Taffy* tree, TextsKind kind, MeasureCalls* calls)
+{
+    Texts texts;
+    taffy_NodeId items[3];
+
+    taffy_Style* root_style = make_style(TEXT_BOX_WIDTH, AUTO);
+    taffy_Style_set_flex_direction(root_style, taffy_FlexDirection_Column);
+
+    if(kind == TEXTS_FIXED_SIZE)
+    {
+        /* stretched to box width: 4 lines of 3 glyphs; words on 3 lines (first one overflows) */
+        texts.glyph = new_leaf(tree, TEXT_BOX_WIDTH, 4.0f * TEXT_LINE_HEIGHT);
+        texts.word  = new_leaf(tree, TEXT_BOX_WIDTH, 3.0f * TEXT_LINE_HEIGHT);
+        texts.line  = new_leaf(tree, TEXT_BOX_WIDTH, TEXT_LINE_HEIGHT);
+    }
+    else
+    {
+        if(kind == TEXTS_MEASURED)
+        {
+            taffy_Style* style = taffy_Style_new_default();
+            const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_leaf_with_measure(tree, style, measure_glyphs, calls);
+            taffy_Style_delete(style);
+
+            CHECK_OK(result);
+            texts.glyph = result.value;
+        }
+        else
+        {
+            texts.glyph = new_text(tree, taffy_FixedText_Wrap_Glyph);
+        }
+        texts.word = new_text(tree, taffy_FixedText_Wrap_Word);
+        texts.line = new_text(tree, taffy_FixedText_Wrap_None);
+    }
+
+    items[0] = texts.glyph;
+    items[1] = texts.word;
+    items[2] = texts.line;
+    {
+        const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_with_children(tree, root_style, items, 3);
+        CHECK_OK(result);
+        texts.root = result.value;
+    }
+
+    taffy_Style_delete(root_style);
+    return texts;
+}
+
+static int texts_eq(const taffy_Taffy* tree1, Texts t1, const taffy_Taffy* tree2, Texts t2)
+{
+    return
+        rect_eq( layout_of(tree1, t1.root ), layout_of(tree2, t2.root ) ) &&
+        rect_eq( layout_of(tree1, t1.glyph), layout_of(tree2, t2.glyph) ) &&
+        rect_eq( layout_of(tree1, t1.word ), layout_of(tree2, t2.word ) ) &&
+        rect_eq( layout_of(tree1, t1.line ), layout_of(tree2, t2.line ) );
+}
+
+static void test_measure_functions(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    MeasureCalls calls = { 0 };
+    Texts texts, expected_texts;
+
+    texts          = build_texts(tree,     TEXTS_MEASURED,   &calls);
+    expected_texts = build_texts(expected, TEXTS_FIXED_SIZE, NULL);
+
+    CHECK( taffy_Taffy_get_measure_user_data(tree, texts.glyph) == &calls );
+
+    compute(tree,     texts.root,     200.0f, 200.0f);
+    compute(expected, expected_texts.root, 200.0f, 200.0f);
+
+    CHECK( calls.calls > 0 );
+    CHECK( texts_eq(tree, texts, expected, expected_texts) );
+
+    /* removed: empty leaf */
+    CHECK_OK( taffy_Taffy_set_measure(tree, texts.glyph, NULL, NULL) );
+    CHECK( taffy_Taffy_get_measure_user_data(tree, texts.glyph) == NULL );
+
+    calls.calls = 0;
+    compute(tree, texts.root, 200.0f, 200.0f);
+    CHECK( calls.calls == 0 );
+    CHECK( layout_of(tree, texts.glyph).height == 0.0f );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+static void test_fixed_text(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    Texts texts, expected_texts;
+
+    texts          = build_texts(tree,     TEXTS_FIXED_TEXT, NULL);
+    expected_texts = build_texts(expected, TEXTS_FIXED_SIZE, NULL);
+
+    compute(tree,     texts.root,          200.0f, 200.0f);
+    compute(expected, expected_texts.root, 200.0f, 200.0f);
+
+    CHECK( texts_eq(tree, texts, expected, expected_texts) );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+static void test_batch_measure(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    MeasureCalls calls = { 0 }, batch_calls = { 0 };
+    Texts texts, expected_texts;
+
+    texts          = build_texts(tree,     TEXTS_MEASURED,   &calls);
+    expected_texts = build_texts(expected, TEXTS_FIXED_SIZE, NULL);
+
+    taffy_Taffy_set_batch_measure(tree, batch_measure_glyphs, &batch_calls);
+
+    compute(tree,     texts.root,          200.0f, 200.0f);
+    compute(expected, expected_texts.root, 200.0f, 200.0f);
+
+    /* per-node function not called */
+    CHECK( calls.calls == 0 );
+    CHECK( batch_calls.calls > 0 );
+    CHECK( texts_eq(tree, texts, expected, expected_texts) );
+
+    /* disabled: per-node calls again */
+    taffy_Taffy_set_batch_measure(tree, NULL, NULL);
+    CHECK_OK( taffy_Taffy_mark_dirty(tree, texts.glyph) );
+    compute(tree, texts.root, 200.0f, 200.0f);
+
+    CHECK( calls.calls > 0 );
+    CHECK( texts_eq(tree, texts, expected, expected_texts) );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+static void test_measure_cache(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    MeasureCalls calls = { 0 };
+    Texts texts, expected_texts;
+    taffy_MeasureCacheStats stats;
+    size_t first_calls;
+
+    texts          = build_texts(tree,     TEXTS_MEASURED,   &calls);
+    expected_texts = build_texts(expected, TEXTS_FIXED_SIZE, NULL);
+
+    taffy_Taffy_set_measure_cache(tree, 4, 0.0f);
+
+    compute(tree,     texts.root,          200.0f, 200.0f);
+    compute(expected, expected_texts.root, 200.0f, 200.0f);
+    CHECK( texts_eq(tree, texts, expected, expected_texts) );
+
+    first_calls = calls.calls;
+    stats = taffy_Taffy_measure_cache_stats(tree);
+    CHECK( stats.misses == first_calls );
+
+    /* laid out again with the same inputs: all from cache */
+    CHECK_OK( taffy_Taffy_mark_dirty(tree, texts.glyph) );
+    compute(tree, texts.root, 200.0f, 200.0f);
+
+    stats = taffy_Taffy_measure_cache_stats(tree);
+    CHECK( calls.calls == first_calls );
+    CHECK( stats.hits > 0 );
+    CHECK( texts_eq(tree, texts, expected, expected_texts) );
+
+    /* content changed: measured again */
+    CHECK_OK( taffy_Taffy_invalidate_measure(tree, texts.glyph) );
+    compute(tree, texts.root, 200.0f, 200.0f);
+
+    CHECK( calls.calls > first_calls );
+    CHECK( texts_eq(tree, texts, expected, expected_texts) );
+
+    taffy_Taffy_reset_measure_cache_stats(tree);
+    stats = taffy_Taffy_measure_cache_stats(tree);
+    CHECK( (stats.hits == 0) && (stats.misses == 0) && (stats.evictions == 0) );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+/* Traversal ---------------------------------------------------------------- */
+
+static int next_is(const taffy_Taffy* tree, taffy_NodeId node, taffy_NodeId expected)
+{
+    taffy_NodeId sibling;
+    return taffy_Taffy_next_sibling(tree, node, &sibling) && (sibling.id == expected.id);
+}
+
+static int prev_is(const taffy_Taffy* tree, taffy_NodeId node, taffy_NodeId expected)
+{
+    taffy_NodeId sibling;
+    return taffy_Taffy_prev_sibling(tree, node, &sibling) && (sibling.id == expected.id);
+}
+
+static void test_traversal(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    taffy_NodeId leaves[4];
+    taffy_NodeId root, inner, node, parent;
+    taffy_NodeId visited[4];
+    taffy_TreeIter_Frame frames[2], deep_frames[3];
+    taffy_TreeIter iter;
+    size_t depth, count;
+
+    leaves[0] = new_leaf(tree, 1.0f, 1.0f);
+    leaves[1] = new_leaf(tree, 2.0f, 1.0f);
+    leaves[2] = new_leaf(tree, 3.0f, 1.0f);
+    leaves[3] = new_leaf(tree, 4.0f, 1.0f);
+    inner = new_node(tree, AUTO, AUTO, &leaves[3], 1);
+    root  = new_node(tree, AUTO, AUTO, leaves, 3);
+
+    /* root -> [ 0, 1, 2 ] */
+    CHECK( !taffy_Taffy_parent(tree, root, NULL) );
+    CHECK( taffy_Taffy_parent(tree, leaves[1], &parent) && (parent.id == root.id) );
+    CHECK( next_is(tree, leaves[0], leaves[1]) );
+    CHECK( next_is(tree, leaves[1], leaves[2]) );
+    CHECK( !taffy_Taffy_next_sibling(tree, leaves[2], NULL) );
+    CHECK( prev_is(tree, leaves[2], leaves[1]) );
+    CHECK( !taffy_Taffy_prev_sibling(tree, leaves[0], NULL) );
+    CHECK( !taffy_Taffy_next_sibling(tree, root, NULL) );
+
+    /* root -> [ 0, inner, 1, 2 ]: following siblings shifted */
+    CHECK_OK( taffy_Taffy_insert_child_at_index(tree, root, 1, inner) );
+    CHECK( next_is(tree, leaves[0], inner) );
+    CHECK( prev_is(tree, leaves[1], inner) );
+    CHECK( next_is(tree, leaves[1], leaves[2]) );
+    CHECK( !taffy_Taffy_next_sibling(tree, leaves[3], NULL) ); /* only child */
+
+    /* root -> [ inner, 1, 2 ] */
+    CHECK_OK( taffy_Taffy_remove_child(tree, root, leaves[0]) );
+    CHECK( !taffy_Taffy_parent(tree, leaves[0], NULL) );
+    CHECK( !taffy_Taffy_prev_sibling(tree, inner, NULL) );
+    CHECK( prev_is(tree, leaves[2], leaves[1]) );
+
+    /* root -> [ inner, 2 ] */
+    CHECK_OK( taffy_Taffy_remove(tree, leaves[1]) );
+    CHECK( next_is(tree, inner, leaves[2]) );
+    CHECK( prev_is(tree, leaves[2], inner) );
+
+    /* root -> [ 2, 0 ] */
+    CHECK_OK( taffy_Taffy_set_children(tree, root, &leaves[2], 1) );
+    CHECK_OK( taffy_Taffy_add_child(tree, root, leaves[0]) );
+    CHECK( next_is(tree, leaves[2], leaves[0]) );
+    CHECK( prev_is(tree, leaves[0], leaves[2]) );
+    CHECK( !taffy_Taffy_parent(tree, inner, NULL) );
+
+    /* root -> [ 2 -> [ 3 ], 0 ]; pre-order (3 skipped) */
+    CHECK_OK( taffy_Taffy_set_children(tree, inner, NULL, 0) );
+    CHECK_OK( taffy_Taffy_add_child(tree, leaves[2], leaves[3]) );
+
+    taffy_TreeIter_init(&iter, tree, root, taffy_TreeIter_Order_PreOrder, frames, 2);
+    CHECK( taffy_TreeIter_next(&iter, &node, &depth) && (node.id == root.id) && (depth == 0) );
+    CHECK( taffy_TreeIter_next(&iter, &node, &depth) && (node.id == leaves[2].id) && (depth == 1) );
+    taffy_TreeIter_skip_children(&iter); /* 3 */
+    CHECK( taffy_TreeIter_next(&iter, &node, &depth) && (node.id == leaves[0].id) && (depth == 1) );
+    CHECK( !taffy_TreeIter_next(&iter, &node, &depth) );
+    CHECK( !taffy_TreeIter_overflowed(&iter) );
+
+    /* 3 levels - too deep for 2 frames */
+    taffy_TreeIter_init(&iter, tree, root, taffy_TreeIter_Order_PostOrder, frames, 2);
+    while( taffy_TreeIter_next(&iter, NULL, NULL) ) {}
+    CHECK( taffy_TreeIter_overflowed(&iter) );
+
+    taffy_TreeIter_init(&iter, tree, root, taffy_TreeIter_Order_PostOrder, deep_frames, 3);
+    count = 0;
+    while( (count < 4) && taffy_TreeIter_next(&iter, &node, &depth) ) {
+        visited[count++] = node;
+    }
+    CHECK( !taffy_TreeIter_next(&iter, NULL, NULL) );
+    CHECK( !taffy_TreeIter_overflowed(&iter) );
+    CHECK( (count == 4) &&
+        (visited[0].id == leaves[3].id) && (visited[1].id == leaves[2].id) &&
+        (visited[2].id == leaves[0].id) && (visited[3].id == root.id) );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* Reconciler --------------------------------------------------------------- */
+
+static void test_reconciler(void)
+{
+    taffy_Taffy*      tree = taffy_Taffy_new_default();
+    taffy_Reconciler* r    = taffy_Reconciler_new(tree);
+
+    taffy_Style* root_style  = make_style(100.0f, 100.0f);
+    taffy_Style* small_style = make_style(10.0f, 10.0f);
+    taffy_Style* big_style   = make_style(20.0f, 20.0f);
+
+    taffy_ReconcileItem items[3];
+    taffy_NodeId root, a, b, a2, b2;
+
+    items[0].key = 1; items[0].parent_key = 0; items[0].style = root_style;
+    items[1].key = 2; items[1].parent_key = 1; items[1].style = small_style;
+    items[2].key = 3; items[2].parent_key = 1; items[2].style = small_style;
+
+    {
+        const taffy_TaffyResult_of_NodeId result = taffy_Reconciler_reconcile(r, items, 3);
+        CHECK_OK(result);
+        root = result.value;
+    }
+    CHECK( child_count(tree, root) == 2 );
+    CHECK( taffy_Reconciler_find(r, 2, &a) );
+    CHECK( taffy_Reconciler_find(r, 3, &b) );
+
+    compute(tree, root, 100.0f, 100.0f);
+    CHECK( !is_dirty(tree, a) );
+
+    /* The same description: nothing changed */
+    CHECK_OK( taffy_Reconciler_reconcile(r, items, 3) );
+    CHECK( taffy_Reconciler_find(r, 2, &a2) && (a2.id == a.id) );
+    CHECK( !is_dirty(tree, a) );
+    CHECK( !is_dirty(tree, b) );
+
+    /* Changed style and order: nodes kept, only changed ones dirty */
+    items[1].key = 3; items[1].style = big_style;
+    items[2].key = 2; items[2].style = small_style;
+
+    CHECK_OK( taffy_Reconciler_reconcile(r, items, 3) );
+    CHECK( taffy_Reconciler_find(r, 2, &a2) && (a2.id == a.id) );
+    CHECK( taffy_Reconciler_find(r, 3, &b2) && (b2.id == b.id) );
+    CHECK( is_dirty(tree, b) );
+
+    /* changes recorded by tree */
+    {
+        taffy_NodeId dirty[4];
+        const size_t dirty_count = taffy_Taffy_dirty_nodes(tree, dirty, 4);
+
+        CHECK( dirty_count == taffy_Taffy_dirty_count(tree) );
+        CHECK( dirty_count == 2 ); /* 'b' (style), 'root' (children order) */
+        CHECK( (dirty[0].id == b.id) && (dirty[1].id == root.id) );
+    }
+
+    compute(tree, root, 100.0f, 100.0f);
+    CHECK( taffy_Taffy_dirty_count(tree) == 0 );
+    CHECK( layout_of(tree, b).width == 20.0f );
+    CHECK( layout_of(tree, a).x     == 20.0f ); /* after 'b' now */
+
+    /* Missing key: node removed */
+    CHECK_OK( taffy_Reconciler_reconcile(r, items, 2) );
+    CHECK( !taffy_Reconciler_find(r, 2, NULL) );
+    CHECK( child_count(tree, root) == 1 );
+    CHECK( taffy_Taffy_layout(tree, a).error.type == taffy_TaffyError_Type_InvalidInputNode );
+
+    /* Invalid description: tree untouched */
+    items[1].parent_key = 42;
+    {
+        const taffy_TaffyResult_of_NodeId result = taffy_Reconciler_reconcile(r, items, 2);
+        CHECK( result.error.type        == taffy_TaffyError_Type_InvalidParentNode );
+        CHECK( result.error.child_index == 1 );
+    }
+    CHECK( child_count(tree, root) == 1 );
+
+    taffy_Style_delete(big_style);
+    taffy_Style_delete(small_style);
+    taffy_Style_delete(root_style);
+
+    taffy_Reconciler_delete(r);
+    taffy_Taffy_delete(tree);
+}
+
+/* TreeBuilder -------------------------------------------------------------- */
+
+static void test_tree_builder(void)
+{
+    taffy_Taffy*       tree = taffy_Taffy_new_default();
+    taffy_TreeBuilder* b    = taffy_TreeBuilder_new(tree);
+
+    taffy_Style* root_style = make_style(100.0f, AUTO);
+    taffy_Style* item_style = make_style(10.0f, 10.0f);
+
+    taffy_NodeId root, inner, leaf;
+
+    root  = taffy_TreeBuilder_begin_node(b, root_style).value;
+    inner = taffy_TreeBuilder_begin_node(b, item_style).value;
+    leaf  = taffy_TreeBuilder_begin_node(b, item_style).value;
+    CHECK( taffy_TreeBuilder_depth(b) == 3 );
+    CHECK_OK( taffy_TreeBuilder_end_node(b) );
+    CHECK_OK( taffy_TreeBuilder_end_node(b) );
+    CHECK_OK( taffy_TreeBuilder_begin_node(b, item_style) );
+    CHECK_OK( taffy_TreeBuilder_end_node(b) );
+    CHECK_OK( taffy_TreeBuilder_end_node(b) );
+
+    /* root closed: no more nodes */
+    CHECK( taffy_TreeBuilder_begin_node(b, item_style).error.type == taffy_TaffyError_Type_InvalidInputNode );
+    CHECK( taffy_TreeBuilder_end_node(b).error.type == taffy_TaffyError_Type_InvalidInputNode );
+
+    {
+        const taffy_TaffyResult_of_NodeId result = taffy_TreeBuilder_finish(b);
+        CHECK_OK(result);
+        CHECK( result.value.id == root.id );
+    }
+    CHECK( child_count(tree, root)  == 2 );
+    CHECK( child_count(tree, inner) == 1 );
+    CHECK( child_count(tree, leaf)  == 0 );
+
+    compute(tree, root, 100.0f, 100.0f);
+    CHECK( layout_of(tree, root).height == 10.0f );
+
+    /* reset by 'finish()' */
+    CHECK( taffy_TreeBuilder_finish(b).error.type == taffy_TaffyError_Type_InvalidInputNode );
+
+    taffy_Style_delete(item_style);
+    taffy_Style_delete(root_style);
+
+    taffy_TreeBuilder_delete(b);
+    taffy_Taffy_delete(tree);
+}
+
+/* Per-node context --------------------------------------------------------- */
+
+static void test_context(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    int values[2] = { 0, 0 };
+
+    const taffy_NodeId a = new_leaf(tree, 10.0f, 10.0f);
+    taffy_NodeId       b;
+
+    CHECK( taffy_Taffy_get_context(tree, a) == NULL );
+    CHECK_OK( taffy_Taffy_set_context(tree, a, &values[0]) );
+    CHECK( taffy_Taffy_get_context(tree, a) == &values[0] );
+
+    /* removed node's slot reused by new node: context not inherited */
+    CHECK_OK( taffy_Taffy_remove(tree, a) );
+    CHECK( taffy_Taffy_get_context(tree, a) == NULL );
+
+    b = new_leaf(tree, 10.0f, 10.0f);
+    CHECK( taffy_Taffy_get_context(tree, b) == NULL );
+    CHECK_OK( taffy_Taffy_set_context(tree, b, &values[1]) );
+    CHECK( taffy_Taffy_get_context(tree, b) == &values[1] );
+    CHECK( taffy_Taffy_get_context(tree, a) == NULL );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* Dirty nodes -------------------------------------------------------------- */
+
+static void test_dirty_nodes(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    enum { COUNT = 64 };
+
+    taffy_NodeId leaves[COUNT];
+    taffy_NodeId dirty[COUNT];
+    taffy_NodeId root;
+    size_t i;
+
+    for(i = 0; i < COUNT; ++i) {
+        leaves[i] = new_leaf(tree, 1.0f, 1.0f);
+    }
+    root = new_node(tree, AUTO, AUTO, leaves, COUNT);
+    compute(tree, root, 100.0f, 100.0f);
+    CHECK( taffy_Taffy_dirty_count(tree) == 0 );
+
+    /* in order of change, without duplicates */
+    for(i = 0; i < COUNT; ++i) {
+        CHECK_OK( taffy_Taffy_mark_dirty(tree, leaves[COUNT - 1 - i]) );
+    }
+    CHECK_OK( taffy_Taffy_mark_dirty(tree, leaves[0]) );
+    CHECK( taffy_Taffy_dirty_nodes(tree, dirty, COUNT) == COUNT );
+    CHECK( (dirty[0].id == leaves[COUNT - 1].id) && (dirty[COUNT - 1].id == leaves[0].id) );
+
+    /* removed ones dropped, order of others kept */
+    for(i = 0; i < COUNT; i += 2) {
+        CHECK_OK( taffy_Taffy_remove(tree, leaves[i]) );
+    }
+    CHECK( taffy_Taffy_dirty_count(tree) == COUNT / 2 + 1 ); /* + 'root' */
+    CHECK( taffy_Taffy_dirty_nodes(tree, dirty, COUNT) == COUNT / 2 + 1 );
+    CHECK( dirty[0].id == leaves[COUNT - 1].id );
+    CHECK( dirty[1].id == leaves[COUNT - 3].id );
+
+    compute(tree, root, 100.0f, 100.0f);
+    CHECK( taffy_Taffy_dirty_count(tree) == 0 );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* Rounding ----------------------------------------------------------------- */
+
+static void test_rounding(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    taffy_NodeId leaves[3];
+    taffy_NodeId root;
+    int pass;
+
+    leaves[0] = new_leaf(tree, 3.3f, 10.0f);
+    leaves[1] = new_leaf(tree, 3.3f, 10.0f);
+    leaves[2] = new_leaf(tree, 3.3f, 10.0f);
+    root = new_node(tree, AUTO, AUTO, leaves, 3);
+
+    for(pass = 0; pass < 2; ++pass)
+    {
+        /* second pass: partial relayout, not rounds rounded values again */
+        if(pass == 1) {
+            taffy_Taffy_set_rounding_dirty_only(tree, 1);
+            CHECK_OK( taffy_Taffy_mark_dirty(tree, leaves[1]) );
+        }
+
+        compute(tree, root, 100.0f, 100.0f);
+
+        CHECK( layout_of(tree, leaves[0]).x == 0.0f );
+        CHECK( layout_of(tree, leaves[1]).x == 3.0f );
+        CHECK( layout_of(tree, leaves[2]).x == 7.0f );
+        CHECK( layout_of(tree, leaves[0]).width == 3.0f );
+        CHECK( layout_of(tree, leaves[1]).width == 4.0f );
+        CHECK( layout_of(tree, leaves[2]).width == 3.0f );
+        CHECK( layout_of(tree, root).width == 10.0f );
+    }
+
+    /* unrounded layouts kept by tree */
+    taffy_Taffy_disable_rounding(tree);
+    CHECK( layout_of(tree, leaves[1]).x     >  3.29f && layout_of(tree, leaves[1]).x     < 3.31f );
+    CHECK( layout_of(tree, leaves[1]).width >  3.29f && layout_of(tree, leaves[1]).width < 3.31f );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* dirty-only rounding: clean subtree, resized by its parent, rounded again */
+static void test_rounding_sibling_resize(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    Siblings siblings, expected_siblings;
+
+    taffy_Taffy_set_rounding_dirty_only(tree, 1);
+
+    siblings = build_siblings(tree, 20.2f);
+    compute(tree, siblings.root, 200.0f, 200.0f);
+
+    set_leaf_size(tree, siblings.text, 41.7f, 10.0f);
+    CHECK( !is_dirty(tree, siblings.box) );
+    compute(tree, siblings.root, 200.0f, 200.0f);
+
+    expected_siblings = build_siblings(expected, 41.7f);
+    compute(expected, expected_siblings.root, 200.0f, 200.0f);
+
+    CHECK( siblings_eq(tree, siblings, expected, expected_siblings) );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+/* Relayout boundaries ------------------------------------------------------ */
+
+static void test_relayout_boundaries(void)
+{
+    int rounding;
+
+    for(rounding = 0; rounding < 2; ++rounding)
+    {
+        taffy_Taffy* tree     = taffy_Taffy_new_default();
+        taffy_Taffy* expected = taffy_Taffy_new_default();
+
+        Scene scene, expected_scene;
+
+        if(!rounding) {
+            taffy_Taffy_disable_rounding(tree);
+            taffy_Taffy_disable_rounding(expected);
+        }
+
+        scene = build_scene(tree, 5.3f);
+        compute(tree, scene.root, 200.0f, 200.0f);
+
+        /* change inside of boundary: only its subtree laid out again */
+        set_leaf_size(tree, scene.a, 7.6f, 10.0f);
+        compute(tree, scene.root, 200.0f, 200.0f);
+
+        expected_scene = build_scene(expected, 7.6f);
+        compute(expected, expected_scene.root, 200.0f, 200.0f);
+
+        CHECK( scene_eq(tree, scene, expected, expected_scene) );
+        CHECK( !is_dirty(tree, scene.root) );
+        CHECK( !is_dirty(tree, scene.panel) );
+        CHECK( !is_dirty(tree, scene.a) );
+        CHECK( taffy_Taffy_dirty_count(tree) == 0 );
+
+        /* change outside: whole tree */
+        set_leaf_size(tree,     scene.head,          10.2f, 30.0f);
+        set_leaf_size(expected, expected_scene.head, 10.2f, 30.0f);
+        CHECK( is_dirty(tree, scene.root) );
+        compute(tree,     scene.root,          200.0f, 200.0f);
+        compute(expected, expected_scene.root, 200.0f, 200.0f);
+
+        CHECK( scene_eq(tree, scene, expected, expected_scene) );
+        CHECK( !is_dirty(tree, scene.root) );
+
+        taffy_Taffy_delete(expected);
+        taffy_Taffy_delete(tree);
+    }
+}
+
+/* root (row) -> [ panel -> [ x, y ], tail ] */
+typedef struct {
+    taffy_NodeId root;
+    taffy_NodeId panel;
+    taffy_NodeId x;
+    taffy_NodeId y;
+    taffy_NodeId tail;
+} Boxes;
+
+/* 'panel_size' < 0 - auto size panel, flagged as boundary; otherwise - fixed
+   size one (detected boundary) */
+static Boxes build_boxes(taffy_Taffy* tree, float panel_size)
+{
+    Boxes boxes;
+    taffy_NodeId items[2];
+
+    taffy_Style* panel_style = make_style(panel_size, panel_size);
+    taffy_Style_set_flex_shrink(panel_style, 0.0f);
+
+    boxes.x    = new_leaf(tree, 10.0f, 20.0f);
+    boxes.y    = new_leaf(tree, 5.0f, 5.0f);
+    boxes.tail = new_leaf(tree, 10.0f, 10.0f);
+
+    items[0] = boxes.x;
+    items[1] = boxes.y;
+    {
+        const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_with_children(tree, panel_style, items, 2);
+        CHECK_OK(result);
+        boxes.panel = result.value;
+    }
+    if(panel_size < 0.0f) {
+        CHECK_OK( taffy_Taffy_set_relayout_boundary(tree, boxes.panel, 1) );
+    }
+
+    items[0] = boxes.panel;
+    items[1] = boxes.tail;
+    boxes.root = new_node(tree, AUTO, AUTO, items, 2);
+
+    taffy_Style_delete(panel_style);
+    return boxes;
+}
+
+static int boxes_eq(const taffy_Taffy* tree1, Boxes b1, const taffy_Taffy* tree2, Boxes b2)
+{
+    return
+        rect_eq( layout_of(tree1, b1.root ), layout_of(tree2, b2.root ) ) &&
+        rect_eq( layout_of(tree1, b1.panel), layout_of(tree2, b2.panel) ) &&
+        rect_eq( layout_of(tree1, b1.x    ), layout_of(tree2, b2.x    ) ) &&
+        rect_eq( layout_of(tree1, b1.y    ), layout_of(tree2, b2.y    ) ) &&
+        rect_eq( layout_of(tree1, b1.tail ), layout_of(tree2, b2.tail ) );
+}
+
+static void test_relayout_boundaries_flagged(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    Boxes boxes, expected_boxes;
+
+    boxes          = build_boxes(tree,     AUTO);
+    expected_boxes = build_boxes(expected, AUTO);
+    compute(tree, boxes.root, 200.0f, 200.0f);
+
+    /* panel keeps its size: only its subtree laid out again */
+    set_leaf_size(tree,     boxes.y,          5.0f, 8.0f);
+    set_leaf_size(expected, expected_boxes.y, 5.0f, 8.0f);
+    compute(tree,     boxes.root,          200.0f, 200.0f);
+    compute(expected, expected_boxes.root, 200.0f, 200.0f);
+
+    CHECK( boxes_eq(tree, boxes, expected, expected_boxes) );
+    CHECK( !is_dirty(tree, boxes.root) );
+
+    /* panel grows: whole tree (tail moved) */
+    set_leaf_size(tree,     boxes.y,          9.0f, 5.0f);
+    set_leaf_size(expected, expected_boxes.y, 9.0f, 5.0f);
+    compute(tree,     boxes.root,          200.0f, 200.0f);
+    compute(expected, expected_boxes.root, 200.0f, 200.0f);
+
+    CHECK( boxes_eq(tree, boxes, expected, expected_boxes) );
+    CHECK( layout_of(tree, boxes.tail).x == 19.0f );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+
+    /* zero size boundary is laid out too */
+    tree     = taffy_Taffy_new_default();
+    expected = taffy_Taffy_new_default();
+
+    boxes          = build_boxes(tree,     0.0f);
+    expected_boxes = build_boxes(expected, 0.0f);
+    compute(tree, boxes.root, 200.0f, 200.0f);
+
+    set_leaf_size(tree,     boxes.x,          12.0f, 20.0f);
+    set_leaf_size(expected, expected_boxes.x, 12.0f, 20.0f);
+    CHECK( taffy_Taffy_dirty_count(tree) > 0 );
+    compute(tree,     boxes.root,          200.0f, 200.0f);
+    compute(expected, expected_boxes.root, 200.0f, 200.0f);
+
+    CHECK( boxes_eq(tree, boxes, expected, expected_boxes) );
+    CHECK( !is_dirty(tree, boxes.root) );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+static void test_recompute_subtree(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    Scene scene, expected_scene;
+    taffy_TaffyResult_of_void result;
+
+    taffy_Taffy_disable_rounding(tree);
+    taffy_Taffy_disable_rounding(expected);
+
+    scene = build_scene(tree, 5.3f);
+
+    /* tree never laid out */
+    result = taffy_Taffy_recompute_subtree(tree, scene.panel);
+    CHECK( result.error.type == taffy_TaffyError_Type_InvalidInputNode );
+    CHECK( result.error.node.id == scene.root.id );
+
+    compute(tree, scene.root, 200.0f, 200.0f);
+
+    /* fixed size node: the same as whole tree layout */
+    set_leaf_size(tree, scene.a, 7.6f, 10.0f);
+    CHECK_OK( taffy_Taffy_recompute_subtree(tree, scene.panel) );
+
+    expected_scene = build_scene(expected, 7.6f);
+    compute(expected, expected_scene.root, 200.0f, 200.0f);
+    CHECK( scene_eq(tree, scene, expected, expected_scene) );
+
+    /* size depends on parent - not laid out */
+    result = taffy_Taffy_recompute_subtree(tree, scene.head);
+    CHECK( result.error.type == taffy_TaffyError_Type_InvalidInputNode );
+    CHECK( result.error.node.id == scene.head.id );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+static void test_layout_resolved_rounded(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+    taffy_Size_of_AvailableSpace* space = make_space(200.0f, 200.0f);
+
+    Scene scene, expected_scene;
+
+    /* rounding enabled by default; panel at fractional position */
+    scene          = build_scene(tree,     5.3f);
+    expected_scene = build_scene(expected, 7.6f);
+
+    compute(tree, scene.root, 200.0f, 200.0f);
+
+    /* changes inside of panel and outside of it (not moving it) */
+    set_leaf_size(tree,     scene.a,             7.6f, 10.0f);
+    set_leaf_size(tree,     scene.tail,          25.0f, 20.0f);
+    set_leaf_size(expected, expected_scene.tail, 25.0f, 20.0f);
+    compute(expected, expected_scene.root, 200.0f, 200.0f);
+
+    /* only panel laid out and rounded - the same as whole tree layout */
+    CHECK( rect_eq( rect_of(taffy_Taffy_layout_resolved(tree, scene.a, space)), layout_of(expected, expected_scene.a) ) );
+    CHECK( rect_eq( layout_of(tree, scene.b), layout_of(expected, expected_scene.b) ) );
+    CHECK( is_dirty(tree, scene.root) );
+    CHECK( !is_dirty(tree, scene.panel) );
+
+    compute(tree, scene.root, 200.0f, 200.0f);
+    CHECK( scene_eq(tree, scene, expected, expected_scene) );
+
+    taffy_Size_of_AvailableSpace_delete(space);
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+#define VIEWPORTS_COUNT 2
+#define SCENE_NODES_COUNT 6
+
+static void scene_preorder(Scene scene, taffy_NodeId nodes[SCENE_NODES_COUNT])
+{
+    nodes[0] = scene.root;
+    nodes[1] = scene.head;
+    nodes[2] = scene.panel;
+    nodes[3] = scene.a;
+    nodes[4] = scene.b;
+    nodes[5] = scene.tail;
+}
+
+static void test_compute_layout_multi(void)
+{
+    static const float widths [VIEWPORTS_COUNT] = { 200.0f,  70.0f };
+    static const float heights[VIEWPORTS_COUNT] = { 200.0f, 100.0f };
+
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    taffy_Size_of_AvailableSpace* spaces[VIEWPORTS_COUNT];
+    taffy_LayoutBuffers buffers[VIEWPORTS_COUNT];
+    taffy_NodeId nodes[VIEWPORTS_COUNT][SCENE_NODES_COUNT];
+    float x[VIEWPORTS_COUNT][SCENE_NODES_COUNT], y[VIEWPORTS_COUNT][SCENE_NODES_COUNT];
+    float width[VIEWPORTS_COUNT][SCENE_NODES_COUNT], height[VIEWPORTS_COUNT][SCENE_NODES_COUNT];
+    Scene scene, expected_scene;
+    size_t i, j;
+
+    scene          = build_scene(tree,     5.3f);
+    expected_scene = build_scene(expected, 5.3f);
+
+    compute(tree, scene.root, 150.0f, 150.0f);
+
+    for(i = 0; i < VIEWPORTS_COUNT; ++i)
+    {
+        spaces[i] = make_space(widths[i], heights[i]);
+
+        buffers[i].nodes    = nodes[i];
+        buffers[i].x        = x[i];
+        buffers[i].y        = y[i];
+        buffers[i].width    = width[i];
+        buffers[i].height   = height[i];
+        buffers[i].capacity = SCENE_NODES_COUNT;
+        buffers[i].count    = 0;
+    }
+
+    CHECK_OK( taffy_Taffy_compute_layout_multi(tree, scene.root, (const taffy_Size_of_AvailableSpace* const*)spaces, VIEWPORTS_COUNT, buffers, 1) );
+
+    /* each viewport - the same as separate layout */
+    for(i = 0; i < VIEWPORTS_COUNT; ++i)
+    {
+        taffy_NodeId expected_nodes[SCENE_NODES_COUNT], scene_nodes[SCENE_NODES_COUNT];
+        scene_preorder(expected_scene, expected_nodes);
+        scene_preorder(scene,          scene_nodes);
+
+        compute(expected, expected_scene.root, widths[i], heights[i]);
+
+        CHECK( buffers[i].count == SCENE_NODES_COUNT );
+        for(j = 0; j < SCENE_NODES_COUNT; ++j)
+        {
+            const Rect rect = layout_of(expected, expected_nodes[j]);
+
+            CHECK( nodes[i][j].id == scene_nodes[j].id ); /* pre-order */
+            CHECK( (x[i][j] == rect.x) && (y[i][j] == rect.y) );
+            CHECK( (width[i][j] == rect.width) && (height[i][j] == rect.height) );
+        }
+    }
+
+    /* tree own layouts restored */
+    compute(expected, expected_scene.root, 150.0f, 150.0f);
+    CHECK( scene_eq(tree, scene, expected, expected_scene) );
+
+    for(i = 0; i < VIEWPORTS_COUNT; ++i) {
+        taffy_Size_of_AvailableSpace_delete(spaces[i]);
+    }
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+/* Layout visitor ----------------------------------------------------------- */
+
+typedef struct {
+    const taffy_NodeId* skip; /* children skipped (if any) */
+    size_t              stop; /* stopped after this count of visits (if not 0) */
+    size_t              count;
+    taffy_LayoutVisit   visits[SCENE_NODES_COUNT];
+} Visits;
+
+static void visits_init(Visits* visits, const taffy_NodeId* skip, size_t stop)
+{
+    visits->skip  = skip;
+    visits->stop  = stop;
+    visits->count = 0;
+}
+
+static int record_visit(const taffy_LayoutVisit* visit, void* user_data)
+{
+    Visits* visits = (Visits*)user_data;
+
+    if(visits->count < SCENE_NODES_COUNT) {
+        visits->visits[visits->count] = *visit;
+    }
+    ++visits->count;
+
+    if(visits->count == visits->stop) {
+        return taffy_VisitAction_Stop;
+    }
+    return ( (visits->skip != NULL) && (visit->node.id == visits->skip->id) ) ? taffy_VisitAction_SkipChildren : taffy_VisitAction_Continue;
+}
+
+static void test_layout_visitor(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    Scene scene;
+    taffy_NodeId nodes[SCENE_NODES_COUNT];
+    Rect root, panel;
+    Visits visits;
+    size_t i;
+
+    scene = build_scene(tree, 20.0f);
+    scene_preorder(scene, nodes);
+    compute(tree, scene.root, 200.0f, 200.0f);
+
+    root  = layout_of(tree, scene.root);
+    panel = layout_of(tree, scene.panel);
+
+    /* all nodes, in pre-order, with the same layouts */
+    visits_init(&visits, NULL, 0);
+    CHECK_OK( taffy_Taffy_visit_layouts(tree, scene.root, record_visit, &visits) );
+
+    CHECK( visits.count == SCENE_NODES_COUNT );
+    for(i = 0; (i < visits.count) && (i < SCENE_NODES_COUNT); ++i)
+    {
+        const taffy_LayoutVisit* visit = &visits.visits[i];
+        const Rect rect = layout_of(tree, nodes[i]);
+        Rect visit_rect;
+        float abs_x = rect.x, abs_y = rect.y;
+
+        visit_rect.x      = visit->x;
+        visit_rect.y      = visit->y;
+        visit_rect.width  = visit->width;
+        visit_rect.height = visit->height;
+
+        if(i > 0) {
+            abs_x += root.x;
+            abs_y += root.y;
+        }
+        if( (nodes[i].id == scene.a.id) || (nodes[i].id == scene.b.id) ) {
+            abs_x += panel.x;
+            abs_y += panel.y;
+        }
+
+        CHECK( visit->node.id == nodes[i].id );
+        CHECK( rect_eq(visit_rect, rect) );
+        CHECK( (visit->abs_x == abs_x) && (visit->abs_y == abs_y) );
+    }
+    CHECK( (visits.visits[0].parent.id == scene.root.id) && (visits.visits[0].depth == 0) );
+    CHECK( (visits.visits[3].parent.id == scene.panel.id) && (visits.visits[3].depth == 2) );
+
+    /* panel's children skipped */
+    visits_init(&visits, &scene.panel, 0);
+    CHECK_OK( taffy_Taffy_visit_layouts(tree, scene.root, record_visit, &visits) );
+
+    CHECK( visits.count == 4 );
+    CHECK( visits.visits[3].node.id == scene.tail.id );
+
+    /* stopped */
+    visits_init(&visits, NULL, 2);
+    CHECK_OK( taffy_Taffy_visit_layouts(tree, scene.root, record_visit, &visits) );
+
+    CHECK( visits.count == 2 );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* Parallel layout ---------------------------------------------------------- */
+
+#define PANELS_COUNT 4
+#define PANEL_ITEMS_COUNT 3
+
+typedef struct {
+    taffy_NodeId root;
+    taffy_NodeId panels[PANELS_COUNT];
+    taffy_NodeId items[PANELS_COUNT][PANEL_ITEMS_COUNT];
+} Panels;
+
+/* root (row) -> [ panel (fixed size, last one - auto and hinted) -> [ items ] ] */
+static Panels build_panels(taffy_Taffy* tree)
+{
+    Panels panels;
+    size_t i, j;
+
+    for(i = 0; i < PANELS_COUNT; ++i)
+    {
+        const int hinted = (i == PANELS_COUNT - 1);
+
+        taffy_Style* style = make_style(hinted ? AUTO : 50.5f, hinted ? AUTO : 40.0f);
+        taffy_Style_set_flex_shrink(style, 0.0f);
+
+        for(j = 0; j < PANEL_ITEMS_COUNT; ++j) {
+            panels.items[i][j] = new_leaf(tree, 10.3f + (float)j, 5.0f + (float)i);
+        }
+        {
+            const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_with_children(tree, style, panels.items[i], PANEL_ITEMS_COUNT);
+            CHECK_OK(result);
+            panels.panels[i] = result.value;
+        }
+        if(hinted) {
+            CHECK_OK( taffy_Taffy_set_parallel_hint(tree, panels.panels[i], 1) );
+        }
+
+        taffy_Style_delete(style);
+    }
+
+    panels.root = new_node(tree, AUTO, AUTO, panels.panels, PANELS_COUNT);
+    return panels;
+}
+
+static int panels_eq(const taffy_Taffy* tree1, const Panels* p1, const taffy_Taffy* tree2, const Panels* p2)
+{
+    size_t i, j;
+
+    int eq = rect_eq( layout_of(tree1, p1->root), layout_of(tree2, p2->root) );
+    for(i = 0; i < PANELS_COUNT; ++i)
+    {
+        eq = eq && rect_eq( layout_of(tree1, p1->panels[i]), layout_of(tree2, p2->panels[i]) );
+        for(j = 0; j < PANEL_ITEMS_COUNT; ++j) {
+            eq = eq && rect_eq( layout_of(tree1, p1->items[i][j]), layout_of(tree2, p2->items[i][j]) );
+        }
+    }
+    return eq;
+}
+
+static void test_parallel_layout(void)
+{
+    taffy_ThreadPool* pool     = taffy_ThreadPool_new(3);
+    taffy_Taffy*      tree     = taffy_Taffy_new_default();
+    taffy_Taffy*      expected = taffy_Taffy_new_default();
+
+    Panels panels, expected_panels;
+    size_t i;
+
+    taffy_Taffy_set_parallel_layout(tree, pool, 1);
+
+    panels          = build_panels(tree);
+    expected_panels = build_panels(expected);
+
+    compute(tree,     panels.root,          300.0f, 100.0f);
+    compute(expected, expected_panels.root, 300.0f, 100.0f);
+    CHECK( panels_eq(tree, &panels, expected, &expected_panels) );
+
+    /* all panels dirty (hinted one - laid out at its previous size now) */
+    for(i = 0; i < PANELS_COUNT; ++i)
+    {
+        set_leaf_size(tree,     panels.items[i][1],          12.7f, 6.1f);
+        set_leaf_size(expected, expected_panels.items[i][1], 12.7f, 6.1f);
+    }
+
+    compute(tree,     panels.root,          300.0f, 100.0f);
+    compute(expected, expected_panels.root, 300.0f, 100.0f);
+    CHECK( panels_eq(tree, &panels, expected, &expected_panels) );
+    CHECK( !is_dirty(tree, panels.root) );
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+    taffy_ThreadPool_delete(pool);
+}
+
+/* Asynchronous layout ------------------------------------------------------ */
+
+typedef struct {
+    int          calls_count;
+    taffy_NodeId read_node; /* read on worker thread */
+    Rect         read_layout;
+} AsyncDone;
+
+static void on_async_done(taffy_Taffy* tree, taffy_NodeId root, taffy_TaffyResult_of_void result, void* user_data)
+{
+    AsyncDone* done = (AsyncDone*)user_data;
+    (void)root;
+
+    CHECK_OK(result);
+    ++done->calls_count;
+    done->read_layout = layout_of(tree, done->read_node);
+}
+
+static void test_async_layout(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+    taffy_Size_of_AvailableSpace* space = make_space(200.0f, 200.0f);
+
+    Scene scene, expected_scene;
+    AsyncDone done;
+    Rect published;
+    taffy_NodeId created;
+
+    scene          = build_scene(tree,     5.3f);
+    expected_scene = build_scene(expected, 5.3f);
+    compute(expected, expected_scene.root, 200.0f, 200.0f);
+
+    done.calls_count = 0;
+    done.read_node   = scene.a;
+
+    taffy_Taffy_compute_layout_async(tree, scene.root, space, on_async_done, &done);
+    CHECK_OK( taffy_Taffy_compute_layout_wait(tree) );
+    CHECK( done.calls_count == 1 );
+    CHECK( rect_eq(done.read_layout, layout_of(expected, expected_scene.a)) );
+    CHECK( scene_eq(tree, scene, expected, expected_scene) );
+
+    /* published layouts kept while the tree is mutated */
+    published = layout_of(tree, scene.a);
+    set_leaf_size(tree,     scene.a,          7.6f, 10.0f);
+    set_leaf_size(expected, expected_scene.a, 7.6f, 10.0f);
+    CHECK( rect_eq(layout_of(tree, scene.a), published) );
+
+    /* not published node - live layout */
+    created = new_leaf(tree, 1.0f, 1.0f);
+    CHECK( layout_of(tree, created).width == 0.0f );
+
+    taffy_Taffy_compute_layout_async(tree, scene.root, space, on_async_done, &done);
+    CHECK_OK( taffy_Taffy_compute_layout_wait(tree) );
+    compute(expected, expected_scene.root, 200.0f, 200.0f);
+    CHECK( done.calls_count == 2 );
+    CHECK( scene_eq(tree, scene, expected, expected_scene) );
+
+    /* synchronous layout - back to live layouts */
+    set_leaf_size(tree,     scene.head,          10.2f, 30.0f);
+    set_leaf_size(expected, expected_scene.head, 10.2f, 30.0f);
+    compute(tree,     scene.root,          200.0f, 200.0f);
+    compute(expected, expected_scene.root, 200.0f, 200.0f);
+    CHECK( scene_eq(tree, scene, expected, expected_scene) );
+
+    taffy_Size_of_AvailableSpace_delete(space);
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(tree);
+}
+
+static Rect published_layout_of(const taffy_PublishedLayouts* layouts, taffy_NodeId node)
+{
+    return rect_of( taffy_PublishedLayouts_layout(layouts, node) );
+}
+
+static void test_published_layouts(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+    taffy_Size_of_AvailableSpace* space = make_space(200.0f, 200.0f);
+
+    Scene scene;
+    taffy_PublishedLayouts* previous;
+    taffy_PublishedLayouts* current;
+    Rect a;
+
+    scene = build_scene(tree, 5.3f);
+    CHECK( taffy_Taffy_acquire_layouts(tree) == NULL ); /* nothing published */
+
+    taffy_Taffy_compute_layout_async(tree, scene.root, space, NULL, NULL);
+    CHECK_OK( taffy_Taffy_compute_layout_wait(tree) );
+    a = layout_of(tree, scene.a);
+
+    /* held while the next result computed and published */
+    previous = taffy_Taffy_acquire_layouts(tree);
+    CHECK( previous != NULL );
+
+    set_leaf_size(tree, scene.a, 7.6f, 10.0f);
+    taffy_Taffy_compute_layout_async(tree, scene.root, space, NULL, NULL);
+    CHECK_OK( taffy_Taffy_compute_layout_wait(tree) );
+
+    current = taffy_Taffy_acquire_layouts(tree);
+    CHECK( (current != NULL) && (current != previous) );
+    CHECK( rect_eq(published_layout_of(previous, scene.a), a) );
+    CHECK( published_layout_of(current, scene.a).width == 7.6f );
+
+    /* reclaimed buffers reused, acquired ones not */
+    taffy_Taffy_compute_layout_async(tree, scene.root, space, NULL, NULL);
+    CHECK_OK( taffy_Taffy_compute_layout_wait(tree) );
+    CHECK( rect_eq(published_layout_of(previous, scene.a), a) );
+
+    /* outlives the tree */
+    taffy_Taffy_delete(tree);
+    CHECK( rect_eq(published_layout_of(previous, scene.a), a) );
+
+    taffy_PublishedLayouts_release(current);
+    taffy_PublishedLayouts_release(previous);
+    taffy_Size_of_AvailableSpace_delete(space);
+}
+
+/* Parallel trees ----------------------------------------------------------- */
+
+#define TREES_COUNT 4
+
+static void test_layouts_parallel(void)
+{
+    taffy_ThreadPool* pool = taffy_ThreadPool_new(2);
+    taffy_Size_of_AvailableSpace* space = make_space(200.0f, 200.0f);
+
+    taffy_Taffy* trees[TREES_COUNT];
+    taffy_Taffy* expected[TREES_COUNT];
+    taffy_NodeId roots[TREES_COUNT];
+    const taffy_Size_of_AvailableSpace* spaces[TREES_COUNT];
+    taffy_TaffyResult_of_void results[TREES_COUNT];
+    Scene scenes[TREES_COUNT], expected_scenes[TREES_COUNT];
+    size_t i;
+
+    for(i = 0; i < TREES_COUNT; ++i)
+    {
+        trees[i]    = taffy_Taffy_new_default();
+        expected[i] = taffy_Taffy_new_default();
+
+        scenes[i]          = build_scene(trees[i],    5.3f + (float)i);
+        expected_scenes[i] = build_scene(expected[i], 5.3f + (float)i);
+
+        roots[i]  = scenes[i].root;
+        spaces[i] = space;
+
+        compute(expected[i], expected_scenes[i].root, 200.0f, 200.0f);
+    }
+
+    /* published layouts of asynchronous computation dropped */
+    taffy_Taffy_compute_layout_async(trees[0], scenes[0].root, space, NULL, NULL);
+    set_leaf_size(trees[0],    scenes[0].a,          9.9f, 10.0f);
+    set_leaf_size(expected[0], expected_scenes[0].a, 9.9f, 10.0f);
+    compute(expected[0], expected_scenes[0].root, 200.0f, 200.0f);
+
+    taffy_compute_layouts_parallel(trees, roots, spaces, TREES_COUNT, pool, results);
+
+    for(i = 0; i < TREES_COUNT; ++i)
+    {
+        CHECK_OK(results[i]);
+        CHECK( scene_eq(trees[i], scenes[i], expected[i], expected_scenes[i]) );
+    }
+
+    for(i = 0; i < TREES_COUNT; ++i)
+    {
+        taffy_Taffy_delete(expected[i]);
+        taffy_Taffy_delete(trees[i]);
+    }
+    taffy_Size_of_AvailableSpace_delete(space);
+    taffy_ThreadPool_delete(pool);
+}
+
+/* Time-budgeted layout ----------------------------------------------------- */
+
+static void test_layout_step(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* previous = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+    taffy_Size_of_AvailableSpace* space = make_space(300.0f, 100.0f);
+
+    Panels panels, previous_panels, expected_panels;
+    taffy_LayoutStep step;
+    size_t i, steps_count = 0;
+
+    panels          = build_panels(tree);
+    previous_panels = build_panels(previous);
+    expected_panels = build_panels(expected);
+
+    compute(tree,     panels.root,          300.0f, 100.0f);
+    compute(previous, previous_panels.root, 300.0f, 100.0f);
+
+    for(i = 0; i < PANELS_COUNT; ++i)
+    {
+        set_leaf_size(tree,     panels.items[i][1],          12.7f, 6.1f);
+        set_leaf_size(expected, expected_panels.items[i][1], 12.7f, 6.1f);
+    }
+    compute(expected, expected_panels.root, 300.0f, 100.0f);
+
+    /* zero budget: one panel per step, then the whole tree */
+    do {
+        CHECK_OK( taffy_Taffy_compute_layout_step(tree, panels.root, space, 0, &step) );
+        ++steps_count;
+
+        /* panels laid out at 0, 0 - not seen until done */
+        if(!step.done) {
+            CHECK( panels_eq(tree, &panels, previous, &previous_panels) );
+        }
+    } while( !step.done && (steps_count <= PANELS_COUNT + 1) );
+
+    CHECK( step.done );
+    CHECK( steps_count == PANELS_COUNT + 1 );
+    CHECK( panels_eq(tree, &panels, expected, &expected_panels) );
+
+    /* nothing dirty - done by single step */
+    CHECK_OK( taffy_Taffy_compute_layout_step(tree, panels.root, space, 0, &step) );
+    CHECK( step.done );
+    CHECK( panels_eq(tree, &panels, expected, &expected_panels) );
+
+    taffy_Size_of_AvailableSpace_delete(space);
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(previous);
+    taffy_Taffy_delete(tree);
+}
+
+/* Layout snapshot ---------------------------------------------------------- */
+
+static int snapshot_eq(const taffy_LayoutSnapshot* snapshot, Scene scene, const taffy_Taffy* tree, Scene expected)
+{
+    taffy_NodeId nodes[SCENE_NODES_COUNT], expected_nodes[SCENE_NODES_COUNT];
+    size_t i;
+    int eq = 1;
+
+    scene_preorder(scene,    nodes);
+    scene_preorder(expected, expected_nodes);
+
+    for(i = 0; i < SCENE_NODES_COUNT; ++i) {
+        eq = eq && rect_eq( rect_of(taffy_LayoutSnapshot_layout(snapshot, nodes[i])), layout_of(tree, expected_nodes[i]) );
+    }
+    return eq;
+}
+
+static void test_layout_snapshot(void)
+{
+    taffy_Taffy* tree     = taffy_Taffy_new_default();
+    taffy_Taffy* previous = taffy_Taffy_new_default();
+    taffy_Taffy* expected = taffy_Taffy_new_default();
+
+    Scene scene, previous_scene, expected_scene;
+    taffy_LayoutSnapshot *first, *second;
+    taffy_NodeId lone, created;
+
+    scene          = build_scene(tree,     5.3f);
+    previous_scene = build_scene(previous, 5.3f);
+    expected_scene = build_scene(expected, 7.6f);
+
+    /* other root, laid out before */
+    lone = new_leaf(tree, 12.0f, 8.0f);
+    compute(tree, lone, 50.0f, 50.0f);
+
+    compute(tree,     scene.root,          200.0f, 200.0f);
+    compute(previous, previous_scene.root, 200.0f, 200.0f);
+    compute(expected, expected_scene.root, 200.0f, 200.0f);
+
+    first = taffy_Taffy_snapshot(tree);
+    CHECK( taffy_LayoutSnapshot_root(first).id == scene.root.id );
+    CHECK( taffy_LayoutSnapshot_nodes_count(first) == SCENE_NODES_COUNT + 1 );
+    CHECK( snapshot_eq(first, scene, previous, previous_scene) );
+    CHECK( rect_eq( rect_of(taffy_LayoutSnapshot_layout(first, lone)), layout_of(tree, lone) ) );
+
+    /* layouts not changed - the same snapshot */
+    second = taffy_Taffy_snapshot(tree);
+    CHECK( second == first );
+    taffy_LayoutSnapshot_release(second);
+
+    /* changed: new snapshot, the first one keeps its layouts */
+    set_leaf_size(tree, scene.a, 7.6f, 10.0f);
+    created = new_leaf(tree, 1.0f, 1.0f);
+    compute(tree, scene.root, 200.0f, 200.0f);
+
+    second = taffy_Taffy_snapshot(tree);
+    CHECK( second != first );
+    CHECK( snapshot_eq(second, scene, expected, expected_scene) );
+    CHECK( snapshot_eq(first,  scene, previous, previous_scene) );
+    CHECK( taffy_LayoutSnapshot_layout(second, created).error.type == taffy_TaffyError_Type_InvalidInputNode );
+
+    taffy_LayoutSnapshot_release(second);
+    taffy_LayoutSnapshot_release(first);
+
+    taffy_Taffy_delete(expected);
+    taffy_Taffy_delete(previous);
+    taffy_Taffy_delete(tree);
+}
+
+/* Damage rects ------------------------------------------------------------- */
+
+static int rect_contains(taffy_LayoutRect outer, float x, float y, float width, float height)
+{
+    const float eps = 0.001f;
+    return (outer.x <= x + eps) && (outer.y <= y + eps) &&
+        (outer.x + outer.width  + eps >= x + width) &&
+        (outer.y + outer.height + eps >= y + height);
+}
+
+static void test_damage_rects(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    Scene scene;
+    taffy_LayoutRect rects[4];
+    size_t count, i;
+    Rect panel;
+
+    taffy_Taffy_disable_rounding(tree);
+    taffy_Taffy_set_track_layout_changes(tree, 1);
+
+    scene = build_scene(tree, 5.3f);
+    compute(tree, scene.root, 200.0f, 200.0f);
+
+    /* 'a' grows, 'b' moves */
+    set_leaf_size(tree, scene.a, 7.6f, 10.0f);
+    compute(tree, scene.root, 200.0f, 200.0f);
+    panel = layout_of(tree, scene.panel);
+
+    count = taffy_Taffy_damage_rects(tree, scene.root, rects, 1);
+    CHECK( count == 1 );
+    CHECK( rect_contains(rects[0], panel.x,        panel.y, 7.6f, 10.0f) ); /* 'a' current */
+    CHECK( rect_contains(rects[0], panel.x + 5.3f, panel.y, 10.0f, 10.3f) ); /* 'b' previous */
+    CHECK( rect_contains(rects[0], panel.x + 7.6f, panel.y, 10.0f, 10.3f) ); /* 'b' current */
+    CHECK( !rect_contains(rects[0], 0.0f, 0.0f, 30.4f, 30.0f) ); /* 'head' not changed */
+
+    /* more rects allowed: 'head' still not covered */
+    count = taffy_Taffy_damage_rects(tree, scene.root, rects, 4);
+    CHECK( (count >= 1) && (count <= 4) );
+    for(i = 0; i < count; ++i) {
+        CHECK( !rect_contains(rects[i], 0.0f, 0.0f, 30.4f, 30.0f) );
+    }
+
+    /* nothing changed */
+    compute(tree, scene.root, 200.0f, 200.0f);
+    CHECK( taffy_Taffy_damage_rects(tree, scene.root, rects, 4) == 0 );
+
+    taffy_Taffy_delete(tree);
+}
+
+static const taffy_LayoutChange* change_of(const taffy_Taffy* tree, taffy_NodeId node)
+{
+    const taffy_LayoutChanges changes = taffy_Taffy_changed_layouts(tree);
+    size_t i;
+    for(i = 0; i < changes.items_count; ++i) {
+        if(changes.items[i].node.id == node.id) {
+            return &changes.items[i];
+        }
+    }
+    return NULL;
+}
+
+/* clean subtree, resized by its parent: its children changed too */
+static void test_damage_rects_sibling_resize(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    Siblings siblings;
+    const taffy_LayoutChange* change;
+    taffy_LayoutRect rects[1];
+    Rect c2;
+
+    taffy_Taffy_disable_rounding(tree);
+    taffy_Taffy_set_track_layout_changes(tree, 1);
+
+    siblings = build_siblings(tree, 20.0f);
+    compute(tree, siblings.root, 200.0f, 200.0f);
+
+    set_leaf_size(tree, siblings.text, 40.0f, 10.0f);
+    compute(tree, siblings.root, 200.0f, 200.0f);
+    c2 = layout_of(tree, siblings.c2);
+
+    CHECK( change_of(tree, siblings.text) != NULL );
+    CHECK( change_of(tree, siblings.box ) != NULL );
+    CHECK( change_of(tree, siblings.c1  ) != NULL );
+
+    change = change_of(tree, siblings.c2);
+    CHECK( change != NULL );
+    CHECK( change->previous.width > change->current.width );
+    CHECK( (change->current.x == c2.x) && (change->current.width == c2.width) );
+
+    /* 'c2' previous and current (relative to 'box', which moved) */
+    CHECK( taffy_Taffy_damage_rects(tree, siblings.root, rects, 1) == 1 );
+    CHECK( rect_contains(rects[0], 20.0f + change->previous.x, c2.y, change->previous.width, c2.height) );
+    CHECK( rect_contains(rects[0], 40.0f + c2.x, c2.y, c2.width, c2.height) );
+
+    taffy_Taffy_delete(tree);
+}
+
+#define MANY_LEAVES_COUNT 200
+
+static void test_damage_rects_many(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    taffy_NodeId leaves[MANY_LEAVES_COUNT];
+    taffy_NodeId root;
+    taffy_LayoutRect rects[2];
+    size_t count, i;
+    Rect last;
+    int covered;
+
+    taffy_Taffy_disable_rounding(tree);
+    taffy_Taffy_set_track_layout_changes(tree, 1);
+
+    for(i = 0; i < MANY_LEAVES_COUNT; ++i) {
+        leaves[i] = new_leaf(tree, 2.0f, 2.0f);
+    }
+    root = new_node(tree, AUTO, AUTO, leaves, MANY_LEAVES_COUNT);
+    compute(tree, root, 1000.0f, 100.0f);
+
+    /* all leaves after the first one move: many rects, merged pairwise first */
+    set_leaf_size(tree, leaves[0], 3.0f, 2.0f);
+    compute(tree, root, 1000.0f, 100.0f);
+    last = layout_of(tree, leaves[MANY_LEAVES_COUNT - 1]);
+
+    count = taffy_Taffy_damage_rects(tree, root, rects, 2);
+    CHECK( (count >= 1) && (count <= 2) );
+
+    covered = 0;
+    for(i = 0; i < count; ++i) {
+        covered = covered || rect_contains(rects[i], last.x, last.y, last.width, last.height);
+    }
+    CHECK(covered);
+
+    taffy_Taffy_delete(tree);
+}
+
+/* Layout generations ------------------------------------------------------- */
+
+static uint64_t generation_of(const taffy_Taffy* tree, taffy_NodeId node)
+{
+    return taffy_Taffy_layout_generation(tree, node);
+}
+
+static void test_layout_generations(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    Scene scene;
+    uint64_t a, b, head;
+    taffy_NodeId removed, created;
+
+    taffy_Taffy_set_track_layout_generations(tree, 1);
+
+    scene = build_scene(tree, 5.3f);
+    compute(tree, scene.root, 200.0f, 200.0f);
+
+    a    = generation_of(tree, scene.a);
+    b    = generation_of(tree, scene.b);
+    head = generation_of(tree, scene.head);
+    CHECK( (a != 0) && (b != 0) && (head != 0) );
+
+    /* only changed layouts get new generation */
+    set_leaf_size(tree, scene.a, 7.6f, 10.0f);
+    compute(tree, scene.root, 200.0f, 200.0f);
+    CHECK( generation_of(tree, scene.a) > a );
+    CHECK( generation_of(tree, scene.b) > b );
+    CHECK( generation_of(tree, scene.head) == head );
+
+    /* generations not repeated by new node in reused slot */
+    a = generation_of(tree, scene.a);
+    removed = scene.tail;
+    CHECK_OK( taffy_Taffy_remove(tree, removed) );
+    CHECK( generation_of(tree, removed) == 0 );
+
+    created = new_leaf(tree, 20.0f, 20.0f);
+    CHECK_OK( taffy_Taffy_add_child(tree, scene.root, created) );
+    CHECK( generation_of(tree, created) == 0 );
+    compute(tree, scene.root, 200.0f, 200.0f);
+    CHECK( generation_of(tree, created) > a );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* grandchildren of clean node, resized by its parent, get new generation */
+static void test_layout_generations_sibling_resize(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    Siblings siblings;
+    uint64_t text, c1, c2;
+
+    taffy_Taffy_set_track_layout_generations(tree, 1);
+
+    siblings = build_siblings(tree, 20.2f);
+    compute(tree, siblings.root, 200.0f, 200.0f);
+
+    text = generation_of(tree, siblings.text);
+    c1   = generation_of(tree, siblings.c1);
+    c2   = generation_of(tree, siblings.c2);
+
+    set_leaf_size(tree, siblings.text, 41.7f, 10.0f);
+    compute(tree, siblings.root, 200.0f, 200.0f);
+    CHECK( generation_of(tree, siblings.text) > text );
+    CHECK( generation_of(tree, siblings.c1) > c1 );
+    CHECK( generation_of(tree, siblings.c2) > c2 );
+
+    /* nothing changed */
+    c2 = generation_of(tree, siblings.c2);
+    compute(tree, siblings.root, 200.0f, 200.0f);
+    CHECK( generation_of(tree, siblings.c2) == c2 );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* Virtual list ------------------------------------------------------------- */
+
+#define LIST_ROWS_COUNT 1000
+#define LIST_WINDOW_ROW 500
+
+static float row_height(size_t index, void* user_data)
+{
+    return ((const float*)user_data)[index];
+}
+
+static float row_offset(const float* heights, size_t index)
+{
+    float offset = 0.0f;
+    size_t i;
+    for(i = 0; i < index; ++i) {
+        offset += heights[i];
+    }
+    return offset;
+}
+
+static size_t row_at(taffy_Taffy* tree, taffy_NodeId list, float offset)
+{
+    const taffy_TaffyResult_of_size_t result = taffy_Taffy_virtual_list_row_at(tree, list, offset);
+    CHECK_OK(result);
+    return result.value;
+}
+
+static void test_virtual_list(void)
+{
+    taffy_Taffy* tree = taffy_Taffy_new_default();
+
+    float heights[LIST_ROWS_COUNT];
+    taffy_NodeId rows[3];
+    taffy_NodeId list;
+    taffy_Style* style;
+    size_t i;
+    float offset;
+
+    taffy_Taffy_disable_rounding(tree);
+
+    for(i = 0; i < LIST_ROWS_COUNT; ++i) {
+        heights[i] = 10.0f + (float)(i % 3);
+    }
+    for(i = 0; i < 3; ++i) {
+        rows[i] = new_leaf(tree, AUTO, AUTO);
+    }
+
+    style = make_style(100.0f, 200.0f);
+    {
+        const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_virtual_list(tree, style, LIST_ROWS_COUNT, 0.0f, row_height, heights);
+        CHECK_OK(result);
+        list = result.value;
+    }
+    taffy_Style_delete(style);
+
+    /* row search */
+    offset = row_offset(heights, LIST_WINDOW_ROW);
+    CHECK( row_at(tree, list, 0.0f) == 0 );
+    CHECK( row_at(tree, list, offset) == LIST_WINDOW_ROW );
+    CHECK( row_at(tree, list, offset - 0.5f) == LIST_WINDOW_ROW - 1 );
+    CHECK( row_at(tree, list, row_offset(heights, LIST_ROWS_COUNT) + 5.0f) == LIST_ROWS_COUNT );
+
+    /* window rows at their offsets */
+    CHECK_OK( taffy_Taffy_virtual_list_set_window(tree, list, LIST_WINDOW_ROW, rows, 3) );
+    compute(tree, list, 100.0f, 200.0f);
+    CHECK( layout_of(tree, rows[0]).y      == offset );
+    CHECK( layout_of(tree, rows[0]).height == heights[LIST_WINDOW_ROW] );
+    CHECK( layout_of(tree, rows[1]).y      == offset + heights[LIST_WINDOW_ROW] );
+
+    /* single row changed: next rows moved */
+    heights[LIST_WINDOW_ROW] = 30.0f;
+    CHECK_OK( taffy_Taffy_virtual_list_invalidate_rows(tree, list, LIST_WINDOW_ROW, 1) );
+    CHECK_OK( taffy_Taffy_virtual_list_set_window(tree, list, LIST_WINDOW_ROW, rows, 3) );
+    compute(tree, list, 100.0f, 200.0f);
+    CHECK( layout_of(tree, rows[0]).height == 30.0f );
+    CHECK( layout_of(tree, rows[1]).y      == offset + 30.0f );
+    CHECK( row_at(tree, list, offset + 29.0f) == LIST_WINDOW_ROW );
+    CHECK( row_at(tree, list, offset + 30.0f) == LIST_WINDOW_ROW + 1 );
+
+    /* removed together with spacer, window rows kept */
+    CHECK_OK( taffy_Taffy_remove(tree, list) );
+    CHECK_OK( taffy_Taffy_style(tree, rows[0]) );
+
+    taffy_Taffy_delete(tree);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(void)
+{
+    test_measure_functions();
+    test_fixed_text();
+    test_batch_measure();
+    test_measure_cache();
+    test_traversal();
+    test_reconciler();
+    test_tree_builder();
+    test_context();
+    test_dirty_nodes();
+    test_rounding();
+    test_rounding_sibling_resize();
+    test_relayout_boundaries();
+    test_relayout_boundaries_flagged();
+    test_recompute_subtree();
+    test_layout_resolved_rounded();
+    test_compute_layout_multi();
+    test_layout_visitor();
+    test_parallel_layout();
+    test_async_layout();
+    test_published_layouts();
+    test_layouts_parallel();
+    test_layout_step();
+    test_layout_snapshot();
+    test_damage_rects();
+    test_damage_rects_sibling_resize();
+    test_damage_rects_many();
+    test_layout_generations();
+    test_layout_generations_sibling_resize();
+    test_virtual_list();
+
+    if(failures_count > 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures_count);
+        return EXIT_FAILURE;
+    }
+
+    printf("all checks passed\n");
+    return EXIT_SUCCESS;
+}
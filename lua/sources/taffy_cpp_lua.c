@@ -8,6 +8,8 @@
 #include <lualib.h>
 #include <lauxlib.h>
 
+#include <stdint.h> /* for: uintptr_t */
+#include <stdio.h> /* for: sprintf() */
 #include <stdlib.h> /* for: malloc(), free() */
 #include <string.h> /* for: strcmp() */
 
@@ -14559,6 +14561,581 @@ static void lua_push_table_taffy_Style(lua_State* L)
     luaL_setmetatable(L, LUA_META_OBJECT_taffy_Style_namespace);
 }
 
+/* -------------------------------------------------------------------------- */
+/* Taffy */
+
+static const char LUA_META_OBJECT_taffy_Taffy[]           = "taffy_Taffy_mt";
+static const char LUA_META_OBJECT_taffy_Taffy_namespace[] = "taffy_Taffy_namespace_mt";
+
+/*
+    Measure function of node.
+
+    Lua function kept in registry (by reference) and record itself is passed
+    as measure 'user_data' (node's context left to user), so measure calls not
+    create any Lua objects: known
+    dimensions passed as plain numbers (or nil), available space - as number
+    for definite space, or as one of (anchored in registry) strings
+    'min-content' / 'max-content'. Result taken from 2 returned numbers:
+
+        function(known_width, known_height, available_width, available_height)
+            return width, height
+        end
+*/
+typedef struct lua_taffy_Measure {
+    struct lua_taffy_Taffy*   owner;
+    int                       function_ref;
+
+    struct lua_taffy_Measure* prev;
+    struct lua_taffy_Measure* next;
+} lua_taffy_Measure;
+
+typedef struct lua_taffy_Taffy {
+    taffy_Taffy* tree;
+
+    lua_State* L;         /* valid only during 'compute_layout()' call */
+    int        error_ref; /* first error, happened in measure function */
+
+    int min_content_ref;
+    int max_content_ref;
+
+    lua_taffy_Measure* measures; /* all measures - to release them in '__gc' */
+} lua_taffy_Taffy;
+
+/* Arguments and result of single measure call */
+typedef struct lua_taffy_MeasureCall {
+    lua_taffy_Measure*           measure;
+    taffy_MeasureKnownDimensions known_dimensions;
+    taffy_MeasureAvailableSpace  available_space;
+    taffy_MeasureSize            size;
+} lua_taffy_MeasureCall;
+
+/*
+    Protected part of measure call (run by 'lua_pcall()', with call record as
+    light userdata argument): any error here (in measure function, its result
+    check, or memory error while pushing arguments) not goes through C++ code
+    of layout computation.
+*/
+static int lua_taffy_Measure_invoke(lua_State* L)
+{
+    lua_taffy_MeasureCall* call  = (lua_taffy_MeasureCall*)lua_touserdata(L, 1);
+    lua_taffy_Taffy*       owner = call->measure->owner;
+
+    const taffy_MeasureKnownDimensions known_dimensions = call->known_dimensions;
+    const taffy_MeasureAvailableSpace  available_space  = call->available_space;
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, call->measure->function_ref);
+
+    if(known_dimensions.width_is_some) {
+        lua_pushnumber(L, known_dimensions.width);
+    } else {
+        lua_pushnil(L);
+    }
+
+    if(known_dimensions.height_is_some) {
+        lua_pushnumber(L, known_dimensions.height);
+    } else {
+        lua_pushnil(L);
+    }
+
+    switch(available_space.width_type) {
+    case taffy_AvailableSpace_Type_Definite:   { lua_pushnumber(L, available_space.width);                            } break;
+    case taffy_AvailableSpace_Type_MinContent: { lua_rawgeti(L, LUA_REGISTRYINDEX, owner->min_content_ref); } break;
+    case taffy_AvailableSpace_Type_MaxContent: { lua_rawgeti(L, LUA_REGISTRYINDEX, owner->max_content_ref); } break;
+    default:                                   { lua_pushnil(L);                                                      } break;
+    }
+
+    switch(available_space.height_type) {
+    case taffy_AvailableSpace_Type_Definite:   { lua_pushnumber(L, available_space.height);                           } break;
+    case taffy_AvailableSpace_Type_MinContent: { lua_rawgeti(L, LUA_REGISTRYINDEX, owner->min_content_ref); } break;
+    case taffy_AvailableSpace_Type_MaxContent: { lua_rawgeti(L, LUA_REGISTRYINDEX, owner->max_content_ref); } break;
+    default:                                   { lua_pushnil(L);                                                      } break;
+    }
+
+    lua_call(L, 4, 2);
+
+    if( !lua_isnumber(L, -2) || !lua_isnumber(L, -1) ) {
+        return luaL_error(L, "measure function must return 2 numbers: width, height");
+    }
+
+    if( !known_dimensions.width_is_some ) {
+        call->size.width = (float)lua_tonumber(L, -2);
+    }
+    if( !known_dimensions.height_is_some ) {
+        call->size.height = (float)lua_tonumber(L, -1);
+    }
+
+    return 0; /* number of results */
+}
+
+/* Protected 'luaL_ref()' of error (registry may grow, so it may fail too) */
+static int lua_taffy_Measure_ref_error(lua_State* L)
+{
+    lua_settop(L, 1);
+    lua_pushinteger(L, luaL_ref(L, LUA_REGISTRYINDEX)); /* pops error */
+
+    return 1; /* number of results */
+}
+
+static taffy_MeasureSize lua_taffy_Measure_call(
+    taffy_MeasureKnownDimensions known_dimensions,
+    taffy_MeasureAvailableSpace  available_space,
+    void*                        user_data
+)
+{
+    lua_taffy_Measure* measure = (lua_taffy_Measure*)user_data;
+    lua_taffy_Taffy*   owner   = measure->owner;
+    lua_State*         L       = owner->L;
+
+    lua_taffy_MeasureCall call;
+    call.measure          = measure;
+    call.known_dimensions = known_dimensions;
+    call.available_space  = available_space;
+    call.size.width       = known_dimensions.width_is_some  ? known_dimensions.width  : 0.0f;
+    call.size.height      = known_dimensions.height_is_some ? known_dimensions.height : 0.0f;
+
+    /* After first error, layout computation is useless - skip other calls */
+    if( (L == NULL) || (owner->error_ref != LUA_NOREF) ) {
+        return call.size;
+    }
+
+    /*
+        NOTE: only protected calls here, since error (long jump) must not go
+        through C++ code of layout computation. Error rethrown by
+        'compute_layout()'. Pushing light C function and light userdata not
+        allocates, so can not fail.
+    */
+    lua_pushcfunction(L, lua_taffy_Measure_invoke);
+    lua_pushlightuserdata(L, &call);
+    if( lua_pcall(L, 1, 0, 0) != LUA_OK )
+    {
+        lua_pushcfunction(L, lua_taffy_Measure_ref_error);
+        lua_insert(L, -2);
+        if( lua_pcall(L, 1, 1, 0) == LUA_OK ) {
+            owner->error_ref = (int)lua_tointeger(L, -1);
+        } else {
+            owner->error_ref = LUA_REFNIL; /* error lost (out of memory) */
+        }
+        lua_pop(L, 1);
+    }
+
+    return call.size;
+}
+
+/* Creates measure for function at 'function_index' */
+static lua_taffy_Measure* lua_taffy_Taffy_measure_new(lua_State* L, lua_taffy_Taffy* self, int function_index)
+{
+    lua_taffy_Measure* measure = (lua_taffy_Measure*)malloc(sizeof(lua_taffy_Measure));
+    if(measure == NULL) {
+        return NULL;
+    }
+
+    measure->function_ref = LUA_NOREF;
+    measure->owner        = self;
+
+    /* Linked before 'luaL_ref()' (may raise) - released by '__gc' then */
+    measure->prev = NULL;
+    measure->next = self->measures;
+    if(self->measures != NULL) {
+        self->measures->prev = measure;
+    }
+    self->measures = measure;
+
+    lua_pushvalue(L, function_index);
+    measure->function_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    return measure;
+}
+
+static void lua_taffy_Taffy_measure_delete(lua_State* L, lua_taffy_Taffy* self, lua_taffy_Measure* measure)
+{
+    luaL_unref(L, LUA_REGISTRYINDEX, measure->function_ref);
+
+    if(measure->prev != NULL) {
+        measure->prev->next = measure->next;
+    } else {
+        self->measures = measure->next;
+    }
+    if(measure->next != NULL) {
+        measure->next->prev = measure->prev;
+    }
+
+    free(measure);
+}
+
+/*
+    NodeId represented as light userdata (not as integer: 'lua_Integer' may be
+    32-bit, for example with 'LUA_C89_NUMBERS', while NodeId is 64-bit). Light
+    userdata compared by value, so ids may be compared and used as table keys.
+*/
+static taffy_NodeId lua_taffy_check_NodeId(lua_State* L, int index)
+{
+    taffy_NodeId node;
+
+    luaL_checktype(L, index, LUA_TLIGHTUSERDATA);
+    node.id = (uint64_t)(uintptr_t)lua_touserdata(L, index);
+    return node;
+}
+
+#define LUA_TAFFY_NODE_ID_TEXT_SIZE (2 + 16 + 1) /* "0x" + hex digits + '\0' */
+
+/* NodeId in hex, all 64 bits ('lua_pushfstring()' has no 64-bit formats) */
+static const char* lua_taffy_NodeId_text(taffy_NodeId node, char* buffer)
+{
+    sprintf(buffer, "0x%08lx%08lx", (unsigned long)(node.id >> 32), (unsigned long)(node.id & 0xFFFFFFFFu));
+    return buffer;
+}
+
+static void lua_taffy_push_NodeId(lua_State* L, taffy_NodeId node)
+{
+    const uintptr_t value = (uintptr_t)node.id;
+    if( (uint64_t)value != node.id ) {
+        char id_text[LUA_TAFFY_NODE_ID_TEXT_SIZE];
+        luaL_error(L, "node id %s not representable as light userdata", lua_taffy_NodeId_text(node, id_text));
+        return;
+    }
+
+    lua_pushlightuserdata(L, (void*)value);
+}
+
+static int lua_taffy_TaffyError_raise(lua_State* L, const char* function_name, taffy_TaffyError error)
+{
+    char id_text[LUA_TAFFY_NODE_ID_TEXT_SIZE];
+
+    switch(error.type) {
+    case taffy_TaffyError_Type_Ok:                    break;
+    case taffy_TaffyError_Type_ChildIndexOutOfBounds: return luaL_error(L, "%s failed : child index %d out of bounds (child count: %d)", function_name, (int)error.child_index, (int)error.child_count);
+    case taffy_TaffyError_Type_InvalidParentNode:     return luaL_error(L, "%s failed : invalid parent node %s", function_name, lua_taffy_NodeId_text(error.node, id_text));
+    case taffy_TaffyError_Type_InvalidChildNode:      return luaL_error(L, "%s failed : invalid child node %s",  function_name, lua_taffy_NodeId_text(error.node, id_text));
+    case taffy_TaffyError_Type_InvalidInputNode:      return luaL_error(L, "%s failed : invalid input node %s",  function_name, lua_taffy_NodeId_text(error.node, id_text));
+    }
+
+    return 0;
+}
+
+static int lua_taffy_Taffy_new(lua_State* L)
+{
+    const int    with_capacity = (lua_type(L, 1) == LUA_TNUMBER);
+    const size_t capacity      = with_capacity ? (size_t)luaL_checkinteger(L, 1) : 0;
+
+    /*
+        Userdata (empty) with its metatable first, then tree: if anything
+        below raises (out of memory), '__gc' releases what is already created.
+    */
+    lua_taffy_Taffy* self = (lua_taffy_Taffy*)lua_newuserdata(L, sizeof(lua_taffy_Taffy));
+    self->tree            = NULL;
+    self->L               = NULL;
+    self->error_ref       = LUA_NOREF;
+    self->min_content_ref = LUA_NOREF;
+    self->max_content_ref = LUA_NOREF;
+    self->measures        = NULL;
+
+    luaL_setmetatable(L, LUA_META_OBJECT_taffy_Taffy);
+
+    self->tree = with_capacity ? taffy_Taffy_new_with_capacity(capacity) : taffy_Taffy_new_default();
+    if(self->tree == NULL) {
+        return luaL_error(L, "Failed to create taffy_Taffy : taffy_Taffy_new_default() failed");
+    }
+
+    lua_pushstring(L, "min-content");
+    self->min_content_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    lua_pushstring(L, "max-content");
+    self->max_content_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+    return 1; /* number of results */
+}
+
+static int lua_taffy_Taffy_delete(lua_State* L)
+{
+    lua_taffy_Taffy* self = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+
+    if(self->tree == NULL) {
+        return 0; /* number of results */
+    }
+
+    while(self->measures != NULL) {
+        lua_taffy_Taffy_measure_delete(L, self, self->measures);
+    }
+
+    luaL_unref(L, LUA_REGISTRYINDEX, self->error_ref);
+    luaL_unref(L, LUA_REGISTRYINDEX, self->min_content_ref);
+    luaL_unref(L, LUA_REGISTRYINDEX, self->max_content_ref);
+
+    taffy_Taffy_delete(self->tree);
+    self->tree = NULL;
+
+    return 0; /* number of results */
+}
+
+static int lua_taffy_Taffy_new_leaf(lua_State* L)
+{
+    lua_taffy_Taffy* self  = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    taffy_Style**    style = (taffy_Style**)luaL_checkudata(L, 2, LUA_META_OBJECT_taffy_Style);
+
+    const taffy_TaffyResult_of_NodeId result = taffy_Taffy_new_leaf(self->tree, *style);
+    if(result.error.type != taffy_TaffyError_Type_Ok) {
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'new_leaf'", result.error);
+    }
+
+    lua_taffy_push_NodeId(L, result.value);
+
+    return 1; /* number of results */
+}
+
+static int lua_taffy_Taffy_new_leaf_with_measure(lua_State* L)
+{
+    lua_taffy_Taffy*   self    = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    taffy_Style**      style   = (taffy_Style**)luaL_checkudata(L, 2, LUA_META_OBJECT_taffy_Style);
+    lua_taffy_Measure* measure = NULL;
+
+    taffy_TaffyResult_of_NodeId result;
+
+    luaL_checktype(L, 3, LUA_TFUNCTION);
+
+    measure = lua_taffy_Taffy_measure_new(L, self, 3);
+    if(measure == NULL) {
+        return luaL_error(L, "taffy_Taffy 'new_leaf_with_measure' failed : out of memory");
+    }
+
+    result = taffy_Taffy_new_leaf_with_measure(self->tree, *style, lua_taffy_Measure_call, measure);
+    if(result.error.type != taffy_TaffyError_Type_Ok)
+    {
+        lua_taffy_Taffy_measure_delete(L, self, measure);
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'new_leaf_with_measure'", result.error);
+    }
+
+    lua_taffy_push_NodeId(L, result.value);
+
+    return 1; /* number of results */
+}
+
+static int lua_taffy_Taffy_set_measure(lua_State* L)
+{
+    lua_taffy_Taffy*   self    = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    const taffy_NodeId node    = lua_taffy_check_NodeId(L, 2);
+    lua_taffy_Measure* measure = NULL;
+
+    lua_taffy_Measure* previous = NULL;
+
+    taffy_TaffyResult_of_void result;
+
+    if( lua_isnoneornil(L, 3) )
+    {
+        previous = (lua_taffy_Measure*)taffy_Taffy_get_measure_user_data(self->tree, node);
+
+        result = taffy_Taffy_set_measure(self->tree, node, NULL, NULL);
+        if(result.error.type != taffy_TaffyError_Type_Ok) {
+            return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'set_measure'", result.error);
+        }
+
+        if(previous != NULL) {
+            lua_taffy_Taffy_measure_delete(L, self, previous);
+        }
+
+        return 0; /* number of results */
+    }
+
+    luaL_checktype(L, 3, LUA_TFUNCTION);
+
+    previous = (lua_taffy_Measure*)taffy_Taffy_get_measure_user_data(self->tree, node);
+
+    measure = lua_taffy_Taffy_measure_new(L, self, 3);
+    if(measure == NULL) {
+        return luaL_error(L, "taffy_Taffy 'set_measure' failed : out of memory");
+    }
+
+    result = taffy_Taffy_set_measure(self->tree, node, lua_taffy_Measure_call, measure);
+    if(result.error.type != taffy_TaffyError_Type_Ok)
+    {
+        lua_taffy_Taffy_measure_delete(L, self, measure);
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'set_measure'", result.error);
+    }
+
+    if(previous != NULL) {
+        lua_taffy_Taffy_measure_delete(L, self, previous);
+    }
+
+    return 0; /* number of results */
+}
+
+static int lua_taffy_Taffy_add_child(lua_State* L)
+{
+    lua_taffy_Taffy*   self   = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    const taffy_NodeId parent = lua_taffy_check_NodeId(L, 2);
+    const taffy_NodeId child  = lua_taffy_check_NodeId(L, 3);
+
+    const taffy_TaffyResult_of_void result = taffy_Taffy_add_child(self->tree, parent, child);
+    if(result.error.type != taffy_TaffyError_Type_Ok) {
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'add_child'", result.error);
+    }
+
+    return 0; /* number of results */
+}
+
+static int lua_taffy_Taffy_remove(lua_State* L)
+{
+    lua_taffy_Taffy*   self = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    const taffy_NodeId node = lua_taffy_check_NodeId(L, 2);
+
+    taffy_TaffyResult_of_NodeId result;
+
+    /* All measures of tree set by binding, so 'user_data' is always ours */
+    lua_taffy_Measure* measure = (lua_taffy_Measure*)taffy_Taffy_get_measure_user_data(self->tree, node);
+
+    result = taffy_Taffy_remove(self->tree, node);
+    if(result.error.type != taffy_TaffyError_Type_Ok) {
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'remove'", result.error);
+    }
+
+    if(measure != NULL) {
+        lua_taffy_Taffy_measure_delete(L, self, measure);
+    }
+
+    return 0; /* number of results */
+}
+
+static int lua_taffy_Taffy_mark_dirty(lua_State* L)
+{
+    lua_taffy_Taffy*   self = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    const taffy_NodeId node = lua_taffy_check_NodeId(L, 2);
+
+    const taffy_TaffyResult_of_void result = taffy_Taffy_mark_dirty(self->tree, node);
+    if(result.error.type != taffy_TaffyError_Type_Ok) {
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'mark_dirty'", result.error);
+    }
+
+    return 0; /* number of results */
+}
+
+static int lua_taffy_Taffy_compute_layout(lua_State* L)
+{
+    lua_taffy_Taffy*       self   = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    const taffy_NodeId     node   = lua_taffy_check_NodeId(L, 2);
+    taffy_AvailableSpace** width  = (taffy_AvailableSpace**)luaL_checkudata(L, 3, LUA_META_OBJECT_taffy_AvailableSpace);
+    taffy_AvailableSpace** height = (taffy_AvailableSpace**)luaL_checkudata(L, 4, LUA_META_OBJECT_taffy_AvailableSpace);
+
+    taffy_TaffyResult_of_void result;
+
+    taffy_Size_of_AvailableSpace* available_space = taffy_taffy_Size_of_AvailableSpace_new(*width, *height);
+    if(available_space == NULL) {
+        return luaL_error(L, "taffy_Taffy 'compute_layout' failed : taffy_Size_of_AvailableSpace_new() failed");
+    }
+
+    /* Measure functions called on the same thread (coroutine) */
+    self->L = L;
+    result = taffy_Taffy_compute_layout(self->tree, node, available_space);
+    self->L = NULL;
+
+    taffy_Size_of_AvailableSpace_delete(available_space);
+
+    if(self->error_ref == LUA_REFNIL)
+    {
+        self->error_ref = LUA_NOREF;
+
+        return luaL_error(L, "taffy_Taffy 'compute_layout' failed : measure function failed (not enough memory to keep its error)");
+    }
+
+    if(self->error_ref != LUA_NOREF)
+    {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, self->error_ref);
+
+        luaL_unref(L, LUA_REGISTRYINDEX, self->error_ref);
+        self->error_ref = LUA_NOREF;
+
+        return lua_error(L);
+    }
+
+    if(result.error.type != taffy_TaffyError_Type_Ok) {
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'compute_layout'", result.error);
+    }
+
+    return 0; /* number of results */
+}
+
+/* Returns plain numbers: x, y, width, height */
+static int lua_taffy_Taffy_layout(lua_State* L)
+{
+    lua_taffy_Taffy*   self = (lua_taffy_Taffy*)luaL_checkudata(L, 1, LUA_META_OBJECT_taffy_Taffy);
+    const taffy_NodeId node = lua_taffy_check_NodeId(L, 2);
+
+    const taffy_TaffyResult_of_Layout_const_ref result = taffy_Taffy_layout(self->tree, node);
+    if(result.error.type != taffy_TaffyError_Type_Ok) {
+        return lua_taffy_TaffyError_raise(L, "taffy_Taffy 'layout'", result.error);
+    }
+
+    lua_pushnumber(L, taffy_Point_of_float_get_x    ( taffy_Layout_get_location(result.value) ));
+    lua_pushnumber(L, taffy_Point_of_float_get_y    ( taffy_Layout_get_location(result.value) ));
+    lua_pushnumber(L, taffy_Size_of_float_get_width ( taffy_Layout_get_size    (result.value) ));
+    lua_pushnumber(L, taffy_Size_of_float_get_height( taffy_Layout_get_size    (result.value) ));
+
+    return 4; /* number of results */
+}
+
+/* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
+
+static void lua_push_table_taffy_Taffy(lua_State* L)
+{
+    if( luaL_newmetatable(L, LUA_META_OBJECT_taffy_Taffy) )
+    {
+        /* metatable.__index = metatable */
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -2, "__index");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_delete);
+        lua_setfield(L, -2, "__gc");
+
+        /* metatable.__metatable = "message" <-- metatable protection */
+        lua_pushstring(L, LUA_METATABLE_PROTECTION_MESSAGE);
+        lua_setfield(L, -2, "__metatable");
+
+        /* ------------------------------------------------------------------ */
+
+        lua_pushcfunction(L, lua_taffy_Taffy_new_leaf);
+        lua_setfield(L, -2, "new_leaf");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_new_leaf_with_measure);
+        lua_setfield(L, -2, "new_leaf_with_measure");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_set_measure);
+        lua_setfield(L, -2, "set_measure");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_add_child);
+        lua_setfield(L, -2, "add_child");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_remove);
+        lua_setfield(L, -2, "remove");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_mark_dirty);
+        lua_setfield(L, -2, "mark_dirty");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_compute_layout);
+        lua_setfield(L, -2, "compute_layout");
+
+        lua_pushcfunction(L, lua_taffy_Taffy_layout);
+        lua_setfield(L, -2, "layout");
+    }
+    lua_pop(L, 1);
+
+    if( luaL_newmetatable(L, LUA_META_OBJECT_taffy_Taffy_namespace) )
+    {
+        /* metatable.__index = metatable */
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -2, "__index");
+
+        lua_pushcfunction(L, lua_newindex_disabled);
+        lua_setfield(L, -2, "__newindex");
+
+        /* ------------------------------------------------------------------ */
+
+        lua_pushcfunction(L, lua_taffy_Taffy_new);
+        lua_setfield(L, -2, "new");
+    }
+    lua_pop(L, 1);
+
+    lua_newtable(L);
+    luaL_setmetatable(L, LUA_META_OBJECT_taffy_Taffy_namespace);
+}
+
 /* -------------------------------------------------------------------------- */
 /* luaopen_<name_as_required> */
 int luaopen_libtaffy_cpp_lua(lua_State* L);
@@ -14779,6 +15356,12 @@ int luaopen_libtaffy_cpp_lua(lua_State* L)
             lua_push_table_taffy_Style(L);
             lua_setfield(L, -2, "Style");
         }
+
+        /* Register Taffy */
+        {
+            lua_push_table_taffy_Taffy(L);
+            lua_setfield(L, -2, "Taffy");
+        }
     }
 
     return 1; /* number of results */
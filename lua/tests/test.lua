@@ -4491,4 +4491,78 @@ describe('taffy_cpp lua binding', function()
         end)
     end)
 
+    describe('Taffy', function()
+        it('Measure function', function()
+            local tree = t.Taffy.new()
+
+            local calls = 0
+            local leaf = tree:new_leaf_with_measure(t.Style.DEFAULT(), function(known_width, known_height, available_width, available_height)
+                calls = calls + 1
+
+                expect( known_width ).to.be( nil )
+                expect( known_height ).to.be( nil )
+                expect( available_width == 'min-content' or available_width == 'max-content' or type(available_width) == 'number' ).to.be( true )
+
+                return 42, 24
+            end)
+
+            tree:compute_layout(leaf, t.AvailableSpace.MaxContent(), t.AvailableSpace.MaxContent())
+
+            local x, y, width, height = tree:layout(leaf)
+            expect( x ).to.be( 0 )
+            expect( y ).to.be( 0 )
+            expect( width ).to.be( 42 )
+            expect( height ).to.be( 24 )
+            expect( calls > 0 ).to.be( true )
+        end)
+
+        it('Measure function replacement and removal', function()
+            local tree = t.Taffy.new()
+
+            local root = tree:new_leaf(t.Style.DEFAULT())
+            local leaf = tree:new_leaf(t.Style.DEFAULT())
+            tree:add_child(root, leaf)
+
+            tree:set_measure(leaf, function() return 10, 20 end)
+            tree:compute_layout(root, t.AvailableSpace.MaxContent(), t.AvailableSpace.MaxContent())
+            local _, _, width, height = tree:layout(leaf)
+            expect( width ).to.be( 10 )
+            expect( height ).to.be( 20 )
+
+            tree:set_measure(leaf, nil)
+            tree:compute_layout(root, t.AvailableSpace.MaxContent(), t.AvailableSpace.MaxContent())
+            _, _, width, height = tree:layout(leaf)
+            expect( width ).to.be( 0 )
+            expect( height ).to.be( 0 )
+        end)
+
+        it('Node ids', function()
+            local tree = t.Taffy.new()
+
+            local a = tree:new_leaf(t.Style.DEFAULT())
+            local b = tree:new_leaf(t.Style.DEFAULT())
+            expect( type(a) ).to.be( 'userdata' )
+            expect( a == b ).to.be( false )
+
+            local names = { [a] = 'a', [b] = 'b' }
+            expect( names[a] ).to.be( 'a' )
+            expect( names[b] ).to.be( 'b' )
+
+            tree:set_measure(b, function() return 1, 2 end)
+            tree:remove(b)
+            expect( function() tree:layout(b) end ).to.fail()
+            expect( function() tree:layout(42) end ).to.fail()
+        end)
+
+        it('Measure function errors', function()
+            local tree = t.Taffy.new()
+
+            local leaf = tree:new_leaf_with_measure(t.Style.DEFAULT(), function() error('measure failed') end)
+            expect( function() tree:compute_layout(leaf, t.AvailableSpace.MaxContent(), t.AvailableSpace.MaxContent()) end ).to.fail()
+
+            tree:set_measure(leaf, function() return 'wrong' end)
+            expect( function() tree:compute_layout(leaf, t.AvailableSpace.MaxContent(), t.AvailableSpace.MaxContent()) end ).to.fail()
+        end)
+    end)
+
 end)